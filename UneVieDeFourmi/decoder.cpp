@@ -0,0 +1,99 @@
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <exception>
+#include <vector>
+#include "include/BinarySchedule.h"
+#include "include/MappedFile.h"
+#include "include/ScheduleWriter.h"
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cerr << "Usage : " << program << " <solution file> [--step <number>] [--output <text file>]" << std::endl;
+}
+
+bool readValue(int argc, char* argv[], int& i, std::string& value) {
+    // The value follows its option and is never another option
+    if (i + 1 >= argc || std::strncmp(argv[i + 1], "--", 2) == 0) return false;
+    value = argv[++i];
+    return true;
+}
+
+bool readNumber(const std::string& text, long long& number) {
+    // The whole text must be a number that fits
+    char* end = nullptr;
+    errno = 0;
+    number = std::strtoll(text.c_str(), &end, 10);
+    return !text.empty() && *end == '\0' && errno == 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        std::string filename;
+        std::string outputFile;
+        long long onlyStep = 0;
+
+        // Read the binary solution and the options from the command line, an unknown
+        // option or a missing value stopping with the usage
+        for (int i = 1; i < argc; i++) {
+            const std::string arg = argv[i];
+            std::string value;
+            bool known = true;
+            if (arg == "--step") {
+                known = readValue(argc, argv, i, value) && readNumber(value, onlyStep) && onlyStep > 0;
+            } else if (arg == "--output") {
+                known = readValue(argc, argv, i, outputFile);
+            } else if (arg[0] != '-' && filename.empty()) {
+                filename = arg;
+            } else {
+                known = false;
+            }
+            if (!known) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+        if (filename.empty()) {
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        // The solution is decoded straight from the mapped file
+        MappedFile file(filename);
+        BinaryScheduleReader reader(file.begin(), file.end());
+        const std::vector<std::string>& ids = reader.getRoomIds();
+        std::unique_ptr<ScheduleWriter> output(outputFile.empty() ? new ScheduleWriter()
+                                                                  : new ScheduleWriter(outputFile));
+
+        // A single step is found through the step index, otherwise every step is written
+        long long first = onlyStep > 0 ? onlyStep : 1;
+        long long last = onlyStep > 0 ? onlyStep : reader.getStepCount();
+        std::vector<BinaryMove> moves;
+        for (long long step = first; step <= last; step++) {
+            reader.readStep(step, moves);
+            output->writeStep(step);
+            for (const BinaryMove& move : moves) {
+                output->writeMoves(move.ant, 1, ids[move.from], ids[move.to]);
+            }
+        }
+
+        // The text of a whole solution ends like the one of displayBestSolution
+        if (onlyStep == 0) {
+            output->writeStep(reader.getStepCount() + 1);
+            output->writeLine("All ants have reached the dormitory!");
+        }
+        output->flush();
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error : " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <exception>
+#include "include/AnthillGenerator.h"
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cerr << "Usage : " << program << " corridors|grid2d|grid3d|geometric|hub [--rooms <number>]"
+              << " [--ants <number>] [--seed <number>] [--capacity <maximum>] [--degree <number>]"
+              << " [--width <number>] [--output <anthill file>]" << std::endl;
+}
+
+bool readValue(int argc, char* argv[], int& i, std::string& value) {
+    // The value follows its option and is never another option
+    if (i + 1 >= argc || std::strncmp(argv[i + 1], "--", 2) == 0) return false;
+    value = argv[++i];
+    return true;
+}
+
+bool readNumber(int argc, char* argv[], int& i, long long& number) {
+    // The whole value must be a number that fits
+    std::string value;
+    if (!readValue(argc, argv, i, value)) return false;
+    char* end = nullptr;
+    errno = 0;
+    number = std::strtoll(value.c_str(), &end, 10);
+    return !value.empty() && *end == '\0' && errno == 0;
+}
+
+bool readNumber(int argc, char* argv[], int& i, int& number) {
+    // Numbers that do not fit an int are refused rather than truncated
+    long long value = 0;
+    if (!readNumber(argc, argv, i, value) || value < INT_MIN || value > INT_MAX) return false;
+    number = static_cast<int>(value);
+    return true;
+}
+
+bool readSeed(int argc, char* argv[], int& i, uint64_t& seed) {
+    // Any 64-bit value, without a sign
+    std::string value;
+    if (!readValue(argc, argv, i, value) || value.empty() || value[0] < '0' || value[0] > '9') return false;
+    char* end = nullptr;
+    errno = 0;
+    seed = std::strtoull(value.c_str(), &end, 10);
+    return *end == '\0' && errno == 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        GeneratorSettings settings;
+        std::string familyName;
+        std::string outputFile;
+
+        // Read the family and its parameters from the command line, an unknown option,
+        // a missing value or a second family stopping with the usage
+        for (int i = 1; i < argc; i++) {
+            const std::string arg = argv[i];
+            bool known = true;
+            if (arg == "--rooms") {
+                known = readNumber(argc, argv, i, settings.rooms);
+            } else if (arg == "--ants") {
+                known = readNumber(argc, argv, i, settings.ants);
+            } else if (arg == "--seed") {
+                known = readSeed(argc, argv, i, settings.seed);
+            } else if (arg == "--capacity") {
+                known = readNumber(argc, argv, i, settings.max_capacity);
+            } else if (arg == "--degree") {
+                known = readNumber(argc, argv, i, settings.degree);
+            } else if (arg == "--width") {
+                known = readNumber(argc, argv, i, settings.width);
+            } else if (arg == "--output") {
+                known = readValue(argc, argv, i, outputFile);
+            } else if (familyName.empty()) {
+                familyName = arg;
+            } else {
+                known = false;
+            }
+            if (!known) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+        if (!AnthillGenerator::parseFamily(familyName, settings.family)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        // Write the anthill, reporting its size when it goes to a file
+        AnthillGenerator generator(settings);
+        long long rooms = generator.write(outputFile);
+        if (!outputFile.empty()) {
+            std::cout << "Anthill written : " << rooms << " rooms, " << settings.ants << " ants" << std::endl;
+        }
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error : " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
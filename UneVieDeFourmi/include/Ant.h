@@ -29,7 +29,11 @@ public:
      */
     ~Ant();
 
-    std::string getId() const;
+    /**
+     * @brief Returns the ID of the ant.
+     * @return Constant reference to the ant ID.
+     */
+    const std::string& getId() const;
 
     /**
      * @brief Moves the ant to a new room.
@@ -38,21 +42,6 @@ public:
      */
     void moves(Room* new_room);
 
-    /**
-     * @brief Gets whether movement is currently possible
-     * @return true if movement is allowed, false otherwise
-     */
-    bool getCanMove() const;
-
-    /**
-     * @brief Toggles the movement capability of the ant
-     *
-     * Switches the ant's ability to move between enabled and disabled states.
-     * If the ant can currently move, it will be disabled from moving.
-     * If the ant cannot currently move, it will be enabled to move.
-     */
-    void toggleCanMove();
-
     /**
      * @brief Displays the ant's movement.
      * Shows: id - previous room - current room.
@@ -63,7 +52,6 @@ private:
     std::string const id_ant;   ///< Unique identifier for the ant.
     Room* current_room;         ///< Pointer to the current room.
     Room* previous_room;        ///< Pointer to the previous room (optional).
-    bool canMove;               ///< Flag indicating if the ant can move in the current turn
 };
 
 #endif //ANT_H
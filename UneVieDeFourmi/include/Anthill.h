@@ -2,12 +2,34 @@
 #ifndef ANTHILL_H
 #define ANTHILL_H
 
+#include <cstdint>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
+#include "Deadline.h"
+#include "Graph.h"
+#include "GraphCache.h"
+#include "PathEnumerator.h"
 #include "Room.h"
+#include "RoomFlow.h"
+#include "ScheduleStream.h"
+#include "ScheduleWriter.h"
+#include "ThreadPool.h"
+#include "TimeExpandedScheduler.h"
 
 
+/**
+ * @brief Outcome of a solve, possibly cut short by its time limit.
+ */
+struct SolveResult {
+    int steps;          ///< Number of steps of the best schedule found, -1 if none.
+    int lower_bound;    ///< No schedule takes fewer steps (see LowerBound), -1 if unknown.
+    bool optimal;       ///< Whether steps is proven to be the minimum.
+    bool interrupted;   ///< Whether the time limit stopped a search before it completed.
+};
+
 /**
  * @class Anthill
  * @brief Represents an anthill composed of rooms connected together containing ants.
@@ -18,18 +40,26 @@
 class Anthill {
 public:
     /**
-     * @brief Constructs an Anthill by reading initial data from a file.
+     * @brief Constructs an Anthill by loading a file in a single pass.
      *
-     * The file must start with the number of rooms and ants:
+     * The file is memory-mapped and scanned once, line by line, without copying lines:
      * - Line 1: "r=<number_of_rooms>"
      * - Line 2: "f=<number_of_ants>"
+     * - Room lines, optionally with a capacity: "RoomID {capacity}" (default capacity 1)
+     * - Connection lines: "RoomID1 - RoomID2" (bidirectional)
      *
-     * Initializes the start room "Sv" and places all ants there.
+     * Creates the start room "Sv" holding all ants, the rooms in file order, then the
+     * destination room "Sd", and finally connects the rooms.
      *
-     * @param filename The path to the file containing initial anthill data.
+     * With a cache file, the rooms and tunnels are read from the cache when it was
+     * written from the same file (whatever its number of ants), and the cache is
+     * written after the parse otherwise (see GraphCache).
+     *
+     * @param filename The path to the file containing the anthill description.
+     * @param cache_file The path to the graph cache, empty to always parse the file.
      * @throws std::runtime_error if the file cannot be opened or the format is invalid.
      */
-    explicit Anthill(const std::string& filename);
+    explicit Anthill(const std::string& filename, const std::string& cache_file = "");
 
     /**
      * @brief Destructor frees dynamically allocated rooms.
@@ -37,29 +67,40 @@ public:
     ~Anthill();
 
     /**
-     * @brief Loads rooms from a file.
-     *
-     * The file format expects each room on a separate line, optionally with a capacity:
-     *   RoomID {capacity}
-     * If no capacity is specified, the default capacity is 1.
-     * Adds a destination room "Sd" after loading all rooms.
-     *
-     * @param filename The path to the file containing room definitions.
-     * @throws std::runtime_error if the file cannot be opened.
+     * @brief Tells whether the rooms and tunnels were loaded from the graph cache.
+     * @return true if the cache was used, false if the file was parsed.
      */
-    void loadRooms(const std::string& filename);
+    bool isCached() const;
 
     /**
-     * @brief Loads connections (edges) between rooms from a file.
-     *
-     * The file format expects connections in the form:
-     *   RoomID1 - RoomID2
-     * Connections are bidirectional.
-     *
-     * @param filename The path to the file containing room connections.
-     * @throws std::runtime_error if the file cannot be opened.
+     * @brief Gets the graph of the anthill.
+     * @return The capacities and tunnels of the rooms, by index.
+     */
+    const Graph& getGraph() const;
+
+    /**
+     * @brief Gets the identifiers of the rooms.
+     * @return A copy of the identifier of each room, by index.
+     */
+    std::vector<std::string> getRoomIds() const;
+
+    /**
+     * @brief Gets the start room.
+     * @return Index of the start room "Sv".
      */
-    void loadConnections(const std::string& filename) const;
+    int getStartIndex() const;
+
+    /**
+     * @brief Gets the end room.
+     * @return Index of the end room "Sd".
+     */
+    int getEndIndex() const;
+
+    /**
+     * @brief Gets the number of ants.
+     * @return Number of ants of the anthill.
+     */
+    int getAntCount() const;
 
     /**
      * @brief Displays a map of the anthill, starting from the first room.
@@ -71,10 +112,13 @@ public:
     /**
      * @brief Finds a room by its identifier.
      *
+     * Looks the identifier up in the hash table of interned room IDs, in constant time.
+     * After a load from the graph cache, the table is built by the first lookup.
+     *
      * @param id The identifier of the room to find.
      * @return Pointer to the Room if found, nullptr otherwise.
      */
-    Room* findRoomById(const std::string& id) const;
+    Room* findRoomById(const std::string& id);
 
     /**
      * @brief Moves the first ant from the origin room to the direction room.
@@ -82,38 +126,89 @@ public:
      * Checks if the origin room contains ants and if the destination can accept more ants.
      * Prints appropriate messages if the move is not possible.
      *
+     * Ants are only counted in the start and end rooms. An ant object is created when
+     * it leaves the start room, numbered in the order ants leave it, and destroyed
+     * once it reaches the end room.
+     *
      * @param origin_room Pointer to the room where the ant currently is.
      * @param direction_room Pointer to the room where the ant should move.
      */
     void antMovementDisplay(Room* origin_room, Room* direction_room);
 
+    /**
+     * @brief Moves ants from the origin room to the direction room in one batch.
+     *
+     * Moves the first ants of the origin room that did not move during the current
+     * epoch, as many as requested and as the direction room can take, then displays
+     * each move. The rooms are updated once for the whole batch (Room::transferAnts);
+     * ants are created when leaving the start room and destroyed in the end room,
+     * as in antMovementDisplay.
+     *
+     * @param origin_room Pointer to the room the ants leave.
+     * @param direction_room Pointer to the room the ants enter.
+     * @param count Maximum number of ants to move.
+     * @return Number of ants moved.
+     */
+    int moveAnts(Room* origin_room, Room* direction_room, int count);
+
     /**
      * @brief Displays the best solution by showing ant movements step by step.
      *
      * Simulates and displays the movement of ants through the optimal paths,
      * showing each step of the solution with the format "E<step_number>".
      * Continues until all ants have reached the destination room.
+     *
+     * Each step starts a new movement epoch: ants that moved during an earlier epoch
+     * become free to move again without visiting every room to reset them.
+     *
+     * Only the ants between the start and end rooms exist as objects, so the memory
+     * used does not grow with the number of ants.
+     *
+     * When findOptimalPaths gave quotas for the paths, no more ants than its quota
+     * leave the start room through each path.
+     *
+     * When findOptimalSchedule found a schedule, its moves are displayed instead.
+     *
+     * The steps and moves go through a ScheduleWriter, to the standard output or to
+     * the file given to setSolutionFile, with the same text as std::cout would give.
      */
     void displayBestSolution();
 
     /**
-     * @brief Moves an ant from one room to another without displaying the movement.
+     * @brief Displays the best solution in compressed form.
      *
-     * @param origin_room Pointer to the room where the ant currently is
-     * @param direction_room Pointer to the room where the ant should move
+     * The solution of displayBestSolution is produced step by step by a ScheduleStream,
+     * without Ant objects, and steps repeating the previous moves with shifted ant
+     * numbers are merged: the output holds the fill phase, the steady state once and
+     * the drain phase, ants with consecutive numbers on a single line. Neither the
+     * memory used nor the output grow with the number of ants.
      */
-    void movesAnt(Room* origin_room, Room* direction_room);
+    void displaySolutionSummary();
 
     /**
-     * @brief Resets the movement flag for all ants in the anthill.
+     * @brief Writes the best solution to a file in the compact binary format.
      *
-     * Sets all ants' canMove flag to true, allowing them to move in the next step.
+     * The moves are those of displayBestSolution, produced by a ScheduleStream and
+     * written by a BinaryScheduleWriter; the decoder turns the file back into the text
+     * displayBestSolution would write.
+     *
+     * @param filename Path of the file to write.
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    void writeBinarySolution(const std::string& filename);
+
+    /**
+     * @brief Writes the solution displayed by displayBestSolution to a file.
+     * @param filename Path of the file, or an empty string for the standard output.
      */
-    void resetAllAntsCanMove();
+    void setSolutionFile(const std::string& filename);
 
     /**
      * @brief Simulates ant movement through given paths to count required steps.
      *
+     * Runs on a separate SimulationState: the rooms and ants of the anthill are
+     * left untouched.
+     *
      * @param start Pointer to the start room
      * @param end Pointer to the end room
      * @return Number of steps required to move all ants to the end room
@@ -123,11 +218,42 @@ public:
     /**
      * @brief Searches and stores all possible paths from start to end room.
      *
-     * Uses depth-first search to find all possible paths from "Sv" to "Sd".
-     * Stores results in the allPaths member variable.
+     * Uses an iterative depth-first search (PathEnumerator) to find all possible
+     * paths from "Sv" to "Sd", shared between the worker threads of the anthill when
+     * there are several. Stores results in the allPaths member variable, in the same
+     * order whatever the number of threads.
+     *
+     * The search runs on a ReducedGraph, without the rooms that lie on no path and
+     * with each corridor crossed in a single move, and the paths found are expanded
+     * back to the rooms of the anthill.
+     *
+     * Paths that can never help are not stored: paths with a shortcut between two of
+     * their rooms (a shorter path uses a subset of their rooms), and paths longer than
+     * the number of steps the shortest path alone needs to bring every ant.
+     *
+     * The search stops at the time limit, or once the paths found hold
+     * PathEnumerator::DEFAULT_MAXIMUM_ROOMS rooms. The paths of such a partial search
+     * all come from its first branches, so the paths of a maximum flow (as found by
+     * searchMaxFlowPaths) are added to them: every solve keeps candidates using the
+     * capacity of the whole anthill. The maximum flow is computed before the paths are
+     * enumerated, so that the time limit covers it.
      */
     void searchAllPaths();
 
+    /**
+     * @brief Searches candidate paths with a maximum flow instead of enumerating them.
+     *
+     * Each room is split into an entry and an exit node joined by an arc of its
+     * capacity, and tunnels become uncapacitated arcs in both directions. Dinic's
+     * algorithm computes the maximum flow from "Sv" to "Sd" (bounded by the number of
+     * ants), which is then decomposed into paths stored in the allPaths member variable.
+     * Runs in polynomial time, unlike searchAllPaths whose output grows exponentially.
+     *
+     * The flow (see RoomFlow) is computed once, and also gives the lower bound of
+     * findOptimalPaths.
+     */
+    void searchMaxFlowPaths();
+
     /**
      * @brief Gets the vector of all found paths.
      *
@@ -156,9 +282,95 @@ public:
      * Tests different combinations of paths to find the one that requires
      * the minimum number of steps to move all ants to the destination.
      * Stores the result in the optimalPaths member variable.
+     *
+     * Candidates are the prefixes of allPaths once a search was run. Otherwise
+     * paths are pulled one at a time from a KShortestPaths generator, in the same
+     * order as sortAllPaths, the generator being limited to paths shorter than the
+     * best step count found: only the useful part of the path set is ever built.
+     *
+     * Candidates are pulled by batches of 64 and the combinations of a batch are
+     * simulated concurrently on the worker threads, each on its own copy of the
+     * initial SimulationState.
+     *
+     * As long as the paths of a combination only share the start and end rooms, its
+     * step count is computed in closed form instead, updated from the previous
+     * combination by a MakespanEvaluator, and the ants are then spread over the
+     * selected paths according to the quotas given by computeMakespan.
+     *
+     * Searched paths at least as long as the best step count found are skipped, and
+     * the search stops once every remaining path is.
+     *
+     * Finally, a DisjointPathSelector looks for a subset of the candidates without
+     * shared rooms that needs fewer steps than every combination tried, and keeps it
+     * if it finds one.
+     *
+     * No combination beats the LowerBound of the anthill, displayed first: the search
+     * stops as soon as a combination meets it. Simulations stop once they reach the
+     * best step count of the previous batches, and are displayed as "at least" that.
+     *
+     * Once the time limit is reached, no more candidates are pulled and the batch
+     * pulled so far is scored last. The paths of the maximum flow (see
+     * searchMaxFlowPaths) are then also tried together, so that a search cut short
+     * still ends on a solution using the capacity of the whole anthill.
      */
     void findOptimalPaths();
 
+    /**
+     * @brief Finds a schedule bringing every ant to the destination in the minimum number of steps.
+     *
+     * The selected paths move the ants greedily, which is not always optimal when
+     * several paths share rooms. Starting from their step count, a TimeExpandedScheduler
+     * searches the minimum number of steps over every possible movement of the ants and
+     * stores a schedule achieving it, then used by displayBestSolution. Nothing is stored
+     * when the time-expanded network would be too large, nor when the paths already meet
+     * the lower bound.
+     */
+    void findOptimalSchedule();
+
+    /**
+     * @brief Gives the path search, the optimisation and the schedule search a time limit.
+     *
+     * Once the time limit is reached, each of them stops and keeps the best result found
+     * so far; the following ones keep the result of the previous one. The optimisation
+     * always scores at least one candidate, so a solution is found whenever a path
+     * exists.
+     *
+     * The maximum flow of the anthill, computed once for the lower bound and the max-flow
+     * paths, counts against the time limit too: stopped by it, the flow still gives
+     * paths, but the lower bound is unknown.
+     *
+     * @param seconds Time left from now, in seconds.
+     */
+    void setTimeLimit(double seconds);
+
+    /**
+     * @brief Changes the largest time-expanded network findOptimalSchedule searches.
+     *
+     * Larger anthills, or more steps, need larger networks: the default limit
+     * (TimeExpandedScheduler::DEFAULT_MAXIMUM_ARCS) keeps the search within about 60 MB,
+     * each arc taking about 60 bytes.
+     *
+     * @param arcs Maximum number of arcs, between 1 and TimeExpandedScheduler::LARGEST_MAXIMUM_ARCS.
+     * @throws std::invalid_argument if the limit is out of range.
+     */
+    void setScheduleArcLimit(long long arcs);
+
+    /**
+     * @brief Gets the best solution found so far with how far it may be from the optimum.
+     *
+     * The lower bound is the one computed by findOptimalPaths, unknown when the time
+     * limit stopped the maximum flow it comes from. A solution is optimal when it meets
+     * the bound or when the schedule search completed.
+     *
+     * @return Step count, lower bound and status of the best solution.
+     */
+    SolveResult getSolveResult() const;
+
+    /**
+     * @brief Displays the step count of the best solution, proven optimal or with its gap to the lower bound.
+     */
+    void displaySolveResult() const;
+
     /**
      * @brief Displays a list of paths with their properties.
      *
@@ -168,11 +380,118 @@ public:
     void displayPaths(const std::vector<Path>& paths, const std::string& namePaths) const;
 
 private:
+    /**
+     * @brief Parses the content of an anthill file and builds rooms and connections.
+     *
+     * @param begin Pointer to the first character of the file content.
+     * @param end Pointer just past the last character of the file content.
+     * @throws std::runtime_error if the format is invalid.
+     */
+    void load(const char* begin, const char* end);
+
+    /**
+     * @brief Loads the rooms and tunnels from a graph cache written from the same file.
+     *
+     * @param cache_file Path of the cache.
+     * @param digest Digest of the anthill file.
+     * @param begin Pointer to the first character of the file content.
+     * @param end Pointer just past the last character of the file content.
+     * @return true if the cache was loaded, false if it is missing, invalid or stale.
+     */
+    bool loadCache(const std::string& cache_file, const SourceDigest& digest, const char* begin, const char* end);
+
+    /**
+     * @brief Writes the graph cache of the parsed anthill, warning if it cannot be written.
+     *
+     * @param cache_file Path of the cache.
+     * @param digest Digest of the anthill file.
+     */
+    void writeCache(const std::string& cache_file, const SourceDigest& digest) const;
+
+    /**
+     * @brief Creates a room and interns its identifier.
+     *
+     * @param id Identifier of the room.
+     * @param capacity Maximum number of ants the room can hold.
+     * @return Dense index of the new room.
+     */
+    int addRoom(const std::string& id, int capacity);
+
+    /**
+     * @brief Converts paths of room indices into paths of rooms.
+     *
+     * @param buffer Paths found, as room indices
+     * @param paths Vector receiving the converted paths (previous content is removed)
+     */
+    void storePaths(const PathBuffer& buffer, std::vector<Path>& paths);
+
+    /**
+     * @brief Converts the paths of the maximum flow of the anthill into paths of rooms.
+     *
+     * @param paths Vector receiving the paths (previous content is removed)
+     */
+    void findMaxFlowPaths(std::vector<Path>& paths);
+
+    /**
+     * @brief Gets the maximum flow from the start room to the end room, computing it on first use.
+     *
+     * The flow gives both the lower bound and the max-flow paths, and is computed once
+     * within the time limit; a flow cut short by the time limit is kept as it is.
+     *
+     * @return The flow and its paths.
+     */
+    const RoomFlow& getRoomFlow();
+
+    /**
+     * @brief Gets a room, creating it on first use after a load from the graph cache.
+     *
+     * @param index Dense index of the room.
+     * @return The room.
+     */
+    Room* getRoom(int index);
+
+    /**
+     * @brief Gets the identifier of a room, without creating the room.
+     *
+     * @param index Dense index of the room.
+     * @return A copy of the identifier.
+     */
+    std::string getRoomId(int index) const;
+
+    /**
+     * @brief Gets the worker threads, starting them on first use.
+     * @return The thread pool shared by the parallel searches.
+     */
+    ThreadPool& getWorkers();
+
     int room_count;                  ///< Number of rooms in the anthill
     int ant_count;                   ///< Number of ants in the anthill
-    std::vector<Room*> rooms;        ///< Vector containing all rooms in the anthill
+    Graph graph;                     ///< Rooms capacities, ants counts and tunnels in CSR layout
+    std::unique_ptr<GraphCache> cache;  ///< Mapped graph cache the graph views, null when the file was parsed
+    std::vector<Room*> rooms;        ///< Vector containing all rooms in the anthill, by index (null until used after a cache load)
+    mutable std::unordered_map<std::string, int> room_index;  ///< Index of each room, by room ID (built on demand after a cache load)
+    int start_index;                 ///< Index of the start room "Sv"
+    int end_index;                   ///< Index of the end room "Sd"
     std::vector<Path> allPaths;      ///< Vector containing all possible paths from start to end
+    std::vector<Path> flowPaths;     ///< Max-flow paths added to a partial search, also tried together
+    bool pathsSearched = false;      ///< Whether allPaths was filled by a path search
+    bool cached = false;             ///< Whether the rooms and tunnels came from the graph cache
     std::vector<Path> optimalPaths;  ///< Vector containing the selected optimal paths for the solution
+    std::vector<int> pathQuotas;     ///< Ants sent through each optimal path, empty when not limited
+    std::vector<std::vector<ScheduledMove>> schedule;  ///< Moves of each step of the optimal schedule, if found
+    std::unique_ptr<ThreadPool> workers;  ///< Worker threads shared by the parallel searches, started on first use
+    std::unique_ptr<RoomFlow> room_flow;  ///< Maximum flow of the anthill, computed on first use
+    unsigned move_epoch = 0;         ///< Current movement epoch, an ant moves at most once per epoch
+    int released_ants = 0;           ///< Number of ants that left the start room during the display
+    std::vector<Ant*> moving_ants;   ///< Ants of the batch being moved, reused between batches
+    std::string solution_file;       ///< File receiving the solution, empty for the standard output
+    ScheduleWriter* writer = nullptr;  ///< Output of the moves while the solution is displayed
+    Deadline deadline;               ///< Time limit of the searches, unlimited by default
+    long long schedule_arc_limit = TimeExpandedScheduler::DEFAULT_MAXIMUM_ARCS;  ///< Largest network of the schedule search
+    bool interrupted = false;        ///< Whether the time limit stopped a search
+    int best_steps = -1;             ///< Step count of the best solution found, -1 if none
+    int lower_bound = -1;            ///< Step count no schedule can beat, -1 if unknown
+    bool proven_optimal = false;     ///< Whether the schedule search proved best_steps minimal
 };
 
 #endif //ANTHILL_H
@@ -0,0 +1,141 @@
+/**
+ * @file AnthillGenerator.h
+ * @brief Header file defining the generator of synthetic anthill files
+ */
+
+#ifndef ANTHILLGENERATOR_H
+#define ANTHILLGENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Shape of the generated anthills.
+ */
+enum class AnthillFamily {
+    Corridors,    ///< Layers of rooms, each room linked to rooms of the next layer.
+    Grid2D,       ///< Rectangular grid, from its first column to its last one.
+    Grid3D,       ///< Box-shaped grid, from its first face to its last one.
+    Geometric,    ///< Random points of the unit square, linked when they are close.
+    HubAndSpoke   ///< Parallel corridors joined by large hub rooms.
+};
+
+/**
+ * @brief Parameters of a generated anthill.
+ */
+struct GeneratorSettings {
+    AnthillFamily family = AnthillFamily::Corridors;  ///< Shape of the anthill.
+    long long rooms = 1000;     ///< Maximum number of rooms besides Sv and Sd, rounded down to the shape.
+    long long ants = 100;       ///< Number of ants, at most INT_MAX as the parser reads it.
+    uint64_t seed = 1;          ///< Seed of the random choices, the same seed giving the same file.
+    int max_capacity = 5;       ///< Rooms have a random capacity between 1 and this value.
+    int degree = 3;             ///< Tunnels to the next layer, average neighbors (at least ln(rooms) + 1), or corridors per hub.
+    int width = 8;              ///< Rooms per layer (Corridors) or per corridor (HubAndSpoke).
+};
+
+/**
+ * @class AnthillGenerator
+ * @brief Writes anthill files of a parameterized family from a seed.
+ *
+ * The files use the format read by Anthill: "r=" with the number of rooms including
+ * Sv and Sd, "f=" with the number of ants, a "S<i> { <capacity> }" line per room,
+ * then a "<A> - <B>" line per tunnel, each tunnel written once. Every room leads to
+ * Sd except, possibly, isolated points of the Geometric family.
+ *
+ * Rooms are numbered so that their tunnels follow from their numbers and the seed:
+ * only the Geometric family keeps an array (its points), and files of 10^7 rooms
+ * are written in a few seconds through a large output buffer.
+ *
+ * The random numbers come from splitmix64, so a seed gives the same file on every
+ * platform.
+ */
+class AnthillGenerator {
+public:
+    /** @brief Size of the output buffer, in bytes */
+    static const size_t BUFFER_SIZE;
+
+    /**
+     * @brief Prepares a generator.
+     * @param settings Parameters of the anthill.
+     * @throws std::invalid_argument if a parameter is out of range, or if the shape needs
+     *         more rooms than settings.rooms (a hub group larger than it).
+     */
+    explicit AnthillGenerator(const GeneratorSettings& settings);
+
+    /**
+     * @brief Writes the anthill.
+     * @param filename Path of the file, replaced if it exists, or an empty string for the standard output.
+     * @return Number of rooms written, Sv and Sd included.
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    long long write(const std::string& filename);
+
+    /**
+     * @brief Reads the name of a family.
+     * @param name "corridors", "grid2d", "grid3d", "geometric" or "hub".
+     * @param family Receives the family named.
+     * @return false if the name is unknown.
+     */
+    static bool parseFamily(const std::string& name, AnthillFamily& family);
+
+private:
+    /** @brief Sets room_count and the sizes of the shape from the settings */
+    void computeShape();
+
+    /** @brief Corridors: room (layer, position) linked to degree rooms of the next layer */
+    void writeCorridors();
+
+    /** @brief Grids of two or three dimensions, Sv before the first slice and Sd after the last one */
+    void writeGrid();
+
+    /** @brief Random geometric graph, points within the radius linked */
+    void writeGeometric();
+
+    /** @brief Corridors from Sv to Sd, hubs linking rooms of several corridors */
+    void writeHubAndSpoke();
+
+    /** @brief Writes the "r=" and "f=" lines, once room_count is known */
+    void writeCounts();
+
+    /** @brief Writes a room line */
+    void writeRoom(long long room, long long capacity);
+
+    /** @brief Writes a tunnel line, room 0 being Sv and room rooms + 1 being Sd */
+    void writeTunnel(long long from, long long to);
+
+    /** @brief Writes the identifier of a room */
+    void appendRoom(long long room);
+
+    /** @brief Appends a number to the buffer */
+    void appendNumber(long long value);
+
+    /** @brief Appends characters to the buffer, writing it out when it is full */
+    void append(const char* text, size_t length);
+
+    /** @brief Writes out the content of the buffer */
+    void flush();
+
+    /** @brief Draws the next random number */
+    uint64_t nextRandom();
+
+    /** @brief Draws a random number below a bound */
+    long long randomBelow(long long bound);
+
+    /** @brief Draws a room capacity */
+    int randomCapacity();
+
+    GeneratorSettings settings;  ///< Parameters of the anthill.
+    long long room_count;        ///< Number of rooms of the shape, Sv and Sd excluded.
+    long long length;            ///< Layers (Corridors), grid slices or hub groups (HubAndSpoke).
+    long long height;            ///< Rooms per layer (Corridors) or grid rows.
+    long long depth;             ///< Grid depth, 1 in two dimensions.
+    uint64_t state;              ///< State of splitmix64.
+    std::FILE* file;             ///< File written, nullptr outside write().
+    std::vector<char> buffer;    ///< Characters not written out yet.
+    size_t used;                 ///< Number of characters in the buffer.
+};
+
+#endif //ANTHILLGENERATOR_H
@@ -0,0 +1,75 @@
+/**
+ * @file AnthillReader.h
+ * @brief Header file defining the minimal anthill reader of the verifier
+ */
+
+#ifndef ANTHILLREADER_H
+#define ANTHILLREADER_H
+
+#include <string>
+#include <vector>
+#include "Graph.h"
+
+/**
+ * @class AnthillReader
+ * @brief Reads the rooms and tunnels of an anthill file, without the solver.
+ *
+ * The verifier checks solutions against this reading rather than against Anthill,
+ * so a parsing mistake of the solver cannot hide the moves it allows. The format
+ * read is the one of the bundled anthills:
+ * - "r=<rooms>" then "f=<ants>" on the first two lines,
+ * - a "<id>" or "<id> { <capacity> }" line per room, of capacity 1 by default,
+ * - a "<A> - <B>" line per tunnel, both ways; tunnels naming an undeclared room
+ *   lead nowhere and are left out, like the solver leaves them out.
+ * Blank lines and other lines holding '=' are skipped. The start room "Sv" and the
+ * end room "Sd" are implicit and hold every ant. When an identifier is declared
+ * twice, the first declaration is kept.
+ */
+class AnthillReader {
+public:
+    /**
+     * @brief Reads an anthill file.
+     * @param filename Path of the anthill file.
+     * @throws std::runtime_error if the file cannot be read or a line is malformed.
+     */
+    explicit AnthillReader(const std::string& filename);
+
+    /**
+     * @brief Gets the graph of the anthill.
+     * @return Rooms with their capacities, and tunnels.
+     */
+    const Graph& getGraph() const;
+
+    /**
+     * @brief Gets the identifier of each room.
+     * @return Identifiers, by room index.
+     */
+    const std::vector<std::string>& getRoomIds() const;
+
+    /**
+     * @brief Gets the start room.
+     * @return Index of "Sv".
+     */
+    int getStart() const;
+
+    /**
+     * @brief Gets the end room.
+     * @return Index of "Sd".
+     */
+    int getEnd() const;
+
+    /**
+     * @brief Gets the number of ants.
+     * @return The ant count of the "f=" line.
+     */
+    long long getAntCount() const;
+
+private:
+    Graph graph;                        ///< Rooms and tunnels.
+    std::vector<std::string> room_ids;  ///< Identifier of each room, by index.
+    int start;                          ///< Index of "Sv".
+    int end;                            ///< Index of "Sd".
+    long long ant_count;                ///< Number of ants.
+};
+
+#endif //ANTHILLREADER_H
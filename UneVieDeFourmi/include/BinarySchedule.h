@@ -0,0 +1,170 @@
+/**
+ * @file BinarySchedule.h
+ * @brief Header file defining the compact binary format of a solution
+ */
+
+#ifndef BINARYSCHEDULE_H
+#define BINARYSCHEDULE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "ScheduleStream.h"
+
+/**
+ * @brief Move of a single ant read from a binary solution.
+ */
+struct BinaryMove {
+    long long ant;   ///< Number of the ant, from 1 ("f1").
+    int from;        ///< Index of the room left, in the room table.
+    int to;          ///< Index of the room entered, in the room table.
+};
+
+/**
+ * @class BinaryScheduleWriter
+ * @brief Writes a solution in the compact binary format.
+ *
+ * Every integer is an unsigned LEB128 varint unless stated otherwise:
+ * - Header: the magic "UVDS", a format version byte (1), the number of rooms, each
+ *   room identifier (length then characters), the number of ants, and the indices of
+ *   the start and end rooms in that table.
+ * - One record per step: the number of moves, then for each move the ant number as
+ *   the zigzag-encoded difference from the previous move of the step (from 0 for the
+ *   first one, so each step decodes on its own), the room left and the room entered.
+ * - Step index: the offset of each step record as a little-endian 64-bit integer,
+ *   followed by the offset of the index, the number of steps (both 64-bit) and the
+ *   magic "UVDI". A reader seeks any step in constant time from the end of the file.
+ *
+ * Ants crossing a tunnel together have consecutive numbers, so most moves take
+ * three bytes instead of the dozen of a text line.
+ */
+class BinaryScheduleWriter {
+public:
+    /**
+     * @brief Creates the file and writes the header.
+     * @param filename Path of the file, replaced if it exists.
+     * @param room_ids Identifier of each room, by index.
+     * @param ant_count Number of ants.
+     * @param start Index of the start room.
+     * @param end Index of the end room.
+     * @throws std::runtime_error if the file cannot be opened.
+     */
+    BinaryScheduleWriter(const std::string& filename, const std::vector<std::string>& room_ids,
+                         long long ant_count, int start, int end);
+
+    /**
+     * @brief Finishes the file if finish() was not called, and closes it.
+     */
+    ~BinaryScheduleWriter();
+
+    BinaryScheduleWriter(const BinaryScheduleWriter&) = delete;
+    BinaryScheduleWriter& operator=(const BinaryScheduleWriter&) = delete;
+
+    /**
+     * @brief Writes the record of the next step.
+     * @param moves Moves of the step, ranges of ants being written one ant at a time.
+     */
+    void writeStep(const std::vector<AntMove>& moves);
+
+    /**
+     * @brief Writes the step index and the trailer, then flushes the file.
+     * @throws std::runtime_error if the output fails.
+     */
+    void finish();
+
+private:
+    /** @brief Appends bytes to the buffer, writing it out when it is full */
+    void append(const unsigned char* bytes, size_t length);
+
+    /** @brief Appends an unsigned varint */
+    void appendVarint(uint64_t value);
+
+    /** @brief Appends a little-endian 64-bit integer */
+    void appendFixed(uint64_t value);
+
+    /** @brief Writes out the content of the buffer */
+    void flush();
+
+    std::FILE* file;                    ///< File written.
+    std::vector<unsigned char> buffer;  ///< Bytes not written out yet.
+    size_t used;                        ///< Number of bytes in the buffer.
+    uint64_t offset;                    ///< Position in the file of the next byte.
+    std::vector<uint64_t> step_offsets; ///< Position of each step record.
+    bool finished;                      ///< Whether the trailer was written.
+};
+
+/**
+ * @class BinaryScheduleReader
+ * @brief Reads a solution in the binary format of BinaryScheduleWriter from memory.
+ *
+ * The content (typically a MappedFile) is not copied: steps are decoded on demand,
+ * in any order, through the step index.
+ */
+class BinaryScheduleReader {
+public:
+    /**
+     * @brief Reads the header and the step index.
+     * @param content_begin First byte of the content.
+     * @param content_end Position just past the last byte of the content.
+     * @throws std::runtime_error if the content is not a valid binary solution.
+     */
+    BinaryScheduleReader(const char* content_begin, const char* content_end);
+
+    /**
+     * @brief Gets the identifiers of the rooms.
+     * @return Identifier of each room, by index.
+     */
+    const std::vector<std::string>& getRoomIds() const;
+
+    /**
+     * @brief Gets the number of ants.
+     * @return Number of ants of the solution.
+     */
+    long long getAntCount() const;
+
+    /**
+     * @brief Gets the index of the start room.
+     * @return Index in the room table.
+     */
+    int getStart() const;
+
+    /**
+     * @brief Gets the index of the end room.
+     * @return Index in the room table.
+     */
+    int getEnd() const;
+
+    /**
+     * @brief Gets the number of steps of the solution.
+     * @return Number of step records.
+     */
+    long long getStepCount() const;
+
+    /**
+     * @brief Decodes the moves of a step.
+     * @param step Number of the step, from 1 to getStepCount().
+     * @param moves Receives the moves of the step, in order.
+     * @throws std::runtime_error if the record is invalid.
+     */
+    void readStep(long long step, std::vector<BinaryMove>& moves) const;
+
+private:
+    /** @brief Reads an unsigned varint, moving the cursor past it */
+    uint64_t readVarint(const unsigned char*& cursor, const unsigned char* limit) const;
+
+    /** @brief Reads a little-endian 64-bit integer */
+    static uint64_t readFixed(const unsigned char* cursor);
+
+    const unsigned char* data;          ///< First byte of the content.
+    const unsigned char* data_end;      ///< Position just past the content.
+    const unsigned char* index;         ///< First entry of the step index.
+    std::vector<std::string> room_ids;  ///< Identifier of each room.
+    long long ant_count;                ///< Number of ants.
+    int start;                          ///< Index of the start room.
+    int end;                            ///< Index of the end room.
+    long long step_count;               ///< Number of steps.
+};
+
+#endif //BINARYSCHEDULE_H
@@ -0,0 +1,44 @@
+/**
+ * @file Deadline.h
+ * @brief Header file defining a point in time after which searches stop
+ */
+
+#ifndef DEADLINE_H
+#define DEADLINE_H
+
+#include <chrono>
+
+/**
+ * @class Deadline
+ * @brief Wall-clock time limit shared by the searches of a solve.
+ *
+ * A search checks its deadline every now and then and, once it has expired, stops
+ * and keeps the best result found so far. A default deadline never expires.
+ * Checking a deadline only reads it, so worker threads can share one.
+ */
+class Deadline {
+public:
+    /**
+     * @brief Creates a deadline that never expires.
+     */
+    Deadline();
+
+    /**
+     * @brief Creates a deadline expiring after a duration from now.
+     * @param seconds Time left before the deadline, in seconds: a negative value has
+     *        already expired, and a value past the range of the clock never expires.
+     */
+    explicit Deadline(double seconds);
+
+    /**
+     * @brief Checks if the deadline has passed.
+     * @return true once the time limit is reached, never for an unlimited deadline.
+     */
+    bool hasExpired() const;
+
+private:
+    bool limited;                                   ///< Whether a time limit was given.
+    std::chrono::steady_clock::time_point end;      ///< Time at which the deadline expires.
+};
+
+#endif //DEADLINE_H
@@ -0,0 +1,93 @@
+/**
+ * @file DisjointPathSelector.h
+ * @brief Header file defining the branch-and-bound search of the best set of room-disjoint paths
+ */
+
+#ifndef DISJOINTPATHSELECTOR_H
+#define DISJOINTPATHSELECTOR_H
+
+#include <cstddef>
+#include <vector>
+#include "Deadline.h"
+#include "Makespan.h"
+#include "Path.h"
+
+/**
+ * @class DisjointPathSelector
+ * @brief Chooses, among candidate paths, the room-disjoint subset needing the fewest steps.
+ *
+ * Trying prefixes of the candidates keeps every path of a prefix, even one that shares
+ * a room with an earlier path and slows every larger prefix down. The selector searches
+ * subsets instead: two candidates conflict when they share a room other than the start
+ * and end rooms, and only subsets without conflicts are built, their step count given
+ * by the closed form of MakespanEvaluator.
+ *
+ * The search is a branch and bound. Since adding paths never raises the step count,
+ * the current subset completed with every remaining candidate that does not conflict
+ * with it, conflicts among them ignored, bounds the step count of everything below
+ * it. A branch whose bound is not below the best subset found is abandoned, and the
+ * search ends as soon as a subset meets the lower bound given.
+ *
+ * Only the first MAXIMUM_CANDIDATES candidates are considered, and the search stops
+ * after MAXIMUM_NODES subsets or once its deadline expires, keeping the best one
+ * found so far.
+ */
+class DisjointPathSelector {
+public:
+    /** @brief Maximum number of candidates considered */
+    static const size_t MAXIMUM_CANDIDATES;
+
+    /** @brief Maximum number of subsets explored */
+    static const long long MAXIMUM_NODES;
+
+    /**
+     * @brief Prepares the search among candidate paths.
+     * @param candidates Candidate paths, in the order they are tried.
+     * @param ant_count Number of ants to bring to the end room.
+     * @param room_count Number of rooms of the anthill (room indices are below it).
+     */
+    DisjointPathSelector(const std::vector<Path>& candidates, int ant_count, int room_count);
+
+    /**
+     * @brief Searches the room-disjoint subset needing the fewest steps.
+     * @param upper Number of steps to beat.
+     * @param selection Receives the positions of the chosen candidates, in increasing order.
+     * @param lower Number of steps no subset can beat (see LowerBound).
+     * @return Number of steps of the subset chosen, or -1 if no subset beats upper.
+     */
+    int select(int upper, std::vector<size_t>& selection, int lower = 0);
+
+    /**
+     * @brief Stops the search when a deadline expires.
+     * @param deadline Deadline checked during the search, which must outlive it (none if null).
+     */
+    void setDeadline(const Deadline* deadline);
+
+    /**
+     * @brief Checks if the last search was stopped before exploring every subset.
+     * @return true if the node limit or the deadline cut the search short.
+     */
+    bool wasInterrupted() const;
+
+private:
+    /**
+     * @brief Explores the subsets made of the current one and candidates from a position on.
+     * @param first Position of the first candidate that may be added.
+     * @param evaluator Step count of the current subset.
+     */
+    void branch(size_t first, const MakespanEvaluator& evaluator);
+
+    const std::vector<Path>& candidates;            ///< Candidate paths.
+    size_t candidate_count;                         ///< Number of candidates considered.
+    int ant_count;                                  ///< Number of ants.
+    std::vector<std::vector<size_t>> conflicts;     ///< Later candidates sharing a room with each candidate.
+    std::vector<int> blocked;                       ///< Number of chosen candidates conflicting with each one.
+    std::vector<size_t> chosen;                     ///< Candidates of the current subset.
+    std::vector<size_t> best_selection;             ///< Candidates of the best subset found.
+    int best_steps;                                 ///< Step count of the best subset found.
+    int lower_bound;                                ///< Step count no subset can beat.
+    long long nodes;                                ///< Number of subsets explored.
+    const Deadline* deadline;                       ///< Deadline of the search, null if unlimited.
+};
+
+#endif //DISJOINTPATHSELECTOR_H
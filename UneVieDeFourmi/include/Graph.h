@@ -0,0 +1,165 @@
+/**
+ * @file Graph.h
+ * @brief Header file defining the compressed sparse row (CSR) graph storing the anthill
+ */
+
+#ifndef GRAPH_H
+#define GRAPH_H
+
+#include <utility>
+#include <vector>
+
+/**
+ * @class Graph
+ * @brief Contiguous storage of the rooms and tunnels of an anthill.
+ *
+ * Rooms are dense integer nodes. The arcs leaving node v are stored contiguously
+ * in the neighbor array between getArcBegin(v) and getArcEnd(v), in the order they
+ * were added. Room capacities and occupancies live in parallel arrays indexed by node.
+ *
+ * Nodes can be added at any time, arcs are buffered by addEdge() and laid out
+ * in the CSR arrays by build(). The offset and neighbor arrays can also be viewed
+ * in place, such as in a mapped graph cache, rather than held by the graph.
+ */
+class Graph {
+public:
+    /**
+     * @brief Constructs a graph without nodes.
+     */
+    Graph();
+
+    /**
+     * @brief Copies a graph, the copy viewing the same arrays as the original if it views arrays.
+     * @param other Graph to copy.
+     */
+    Graph(const Graph& other);
+
+    /**
+     * @brief Copies a graph, the copy viewing the same arrays as the original if it views arrays.
+     * @param other Graph to copy.
+     * @return This graph.
+     */
+    Graph& operator=(const Graph& other);
+
+    /**
+     * @brief Adds a node.
+     * @param capacity Maximum number of ants the node can hold.
+     * @return Index of the new node.
+     */
+    int addNode(int capacity);
+
+    /**
+     * @brief Buffers a directed arc, laid out by the next call to build().
+     * @param from Index of the origin node.
+     * @param to Index of the destination node.
+     */
+    void addEdge(int from, int to);
+
+    /**
+     * @brief Lays out the buffered arcs in the offset and neighbor arrays.
+     *
+     * The arcs of each node keep the order in which they were added.
+     */
+    void build();
+
+    /**
+     * @brief Replaces the nodes and arcs with arrays already laid out, such as a cache.
+     *
+     * The capacities are copied, as they can be changed, while the offsets and the
+     * neighbors are used in place: they must outlive the graph, or stay valid until
+     * addNode() or build() copy them. Pending arcs are dropped and every node is
+     * left empty.
+     *
+     * @param node_count Number of nodes.
+     * @param node_capacities Capacity of each node.
+     * @param arc_offsets First arc of each node, plus the total arc count.
+     * @param arc_targets Destination node of each arc.
+     */
+    void view(int node_count, const int* node_capacities, const int* arc_offsets, const int* arc_targets);
+
+    /**
+     * @brief Gets the number of nodes.
+     * @return The node count.
+     */
+    int getNodeCount() const;
+
+    /**
+     * @brief Gets the number of arcs laid out by build().
+     * @return The arc count.
+     */
+    int getArcCount() const;
+
+    /**
+     * @brief Gets the first arc leaving a node.
+     * @param node Index of the node.
+     * @return Index of the first arc of the node.
+     */
+    int getArcBegin(int node) const { return arc_offsets[node]; }
+
+    /**
+     * @brief Gets the position just past the last arc leaving a node.
+     * @param node Index of the node.
+     * @return Index following the last arc of the node.
+     */
+    int getArcEnd(int node) const { return arc_offsets[node + 1]; }
+
+    /**
+     * @brief Gets the node an arc leads to.
+     * @param arc Index of the arc.
+     * @return Index of the destination node.
+     */
+    int getArcTarget(int arc) const { return arc_targets[arc]; }
+
+    /**
+     * @brief Gets the number of arcs leaving a node.
+     * @param node Index of the node.
+     * @return The degree of the node.
+     */
+    int getDegree(int node) const { return arc_offsets[node + 1] - arc_offsets[node]; }
+
+    /**
+     * @brief Gets the maximum number of ants a node can hold.
+     * @param node Index of the node.
+     * @return The capacity of the node.
+     */
+    int getCapacity(int node) const { return capacity[node]; }
+
+    /**
+     * @brief Changes the maximum number of ants a node can hold.
+     * @param node Index of the node.
+     * @param node_capacity The new capacity of the node.
+     */
+    void setCapacity(int node, int node_capacity) { capacity[node] = node_capacity; }
+
+    /**
+     * @brief Gets the number of ants currently in a node.
+     * @param node Index of the node.
+     * @return The occupancy of the node.
+     */
+    int getOccupancy(int node) const { return occupancy[node]; }
+
+    /**
+     * @brief Changes the number of ants in a node.
+     * @param node Index of the node.
+     * @param delta Number of ants added (negative to remove ants).
+     */
+    void addOccupancy(int node, int delta) { occupancy[node] += delta; }
+
+private:
+    /** @brief Copies viewed offsets and neighbors into the graph's own arrays */
+    void ownArcs();
+
+    /** @brief Points the arc arrays at the graph's own offsets and neighbors */
+    void attachArcs();
+
+    std::vector<int> offsets = std::vector<int>(1, 0);  ///< First arc of each node, plus the total arc count.
+    std::vector<int> neighbors;                          ///< Destination node of each arc.
+    std::vector<int> capacity;                           ///< Capacity of each node.
+    std::vector<int> occupancy;                          ///< Number of ants in each node.
+    std::vector<std::pair<int, int>> pending_arcs;       ///< Arcs added since the last build().
+    const int* arc_offsets;                              ///< Offsets in use, owned or viewed.
+    const int* arc_targets;                              ///< Neighbors in use, owned or viewed.
+    bool viewing = false;                                ///< Whether the arc arrays are viewed rather than owned.
+};
+
+#endif //GRAPH_H
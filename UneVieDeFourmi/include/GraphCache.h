@@ -0,0 +1,163 @@
+/**
+ * @file GraphCache.h
+ * @brief Header file defining the binary cache of a parsed anthill graph
+ */
+
+#ifndef GRAPHCACHE_H
+#define GRAPHCACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Graph.h"
+#include "MappedFile.h"
+
+/**
+ * @brief Fingerprint of an anthill file, its "f=" line left out.
+ */
+struct SourceDigest {
+    uint64_t size = 0;          ///< Number of bytes hashed.
+    uint64_t hash[2] = {0, 0};  ///< Two 64-bit hashes of the bytes, computed with different rounds.
+
+    /** @brief Tells whether two digests are the same */
+    bool operator==(const SourceDigest& other) const {
+        return size == other.size && hash[0] == other.hash[0] && hash[1] == other.hash[1];
+    }
+};
+
+/**
+ * @class GraphCache
+ * @brief Memory-mapped binary copy of the rooms and tunnels of an anthill file.
+ *
+ * The cache holds, in the byte order of the machine that wrote it:
+ * - A header: the magic "UVDG", a byte order mark, the format version, the room count
+ *   of the "r=" line, the size and two hashes of the source file, the node and arc
+ *   counts, the start and end nodes, and the size of the identifier table.
+ * - The capacity of each node, the CSR offsets and the CSR neighbors, as 32-bit integers.
+ * - The offset of each room identifier (32-bit, one more than the nodes), then the
+ *   identifiers themselves, concatenated.
+ *
+ * The arrays are used in place, so loading a cache is a mapping, its checks and a
+ * copy of the capacities, without any parsing. The source digest leaves the "f="
+ * line out: the same anthill with another number of ants reuses the cache, the ants
+ * being read from the file.
+ */
+class GraphCache {
+public:
+    /**
+     * @brief Maps a cache file and checks its layout.
+     * @param filename Path of the cache file.
+     * @throws std::runtime_error if the file cannot be mapped or is not a valid cache.
+     */
+    explicit GraphCache(const std::string& filename);
+
+    /**
+     * @brief Writes the cache of a graph, replacing the file atomically.
+     *
+     * The cache is written next to its final path and renamed once complete, so an
+     * interrupted write never leaves a partial cache behind.
+     *
+     * @param filename Path of the cache file.
+     * @param digest Digest of the source file, from hashAnthill().
+     * @param room_count Room count of the "r=" line.
+     * @param graph Graph laid out by Graph::build().
+     * @param room_ids Identifier of each node.
+     * @param start Index of the start node.
+     * @param end Index of the end node.
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    static void write(const std::string& filename, const SourceDigest& digest, int room_count, const Graph& graph,
+                      const std::vector<std::string>& room_ids, int start, int end);
+
+    /**
+     * @brief Hashes the content of an anthill file, except its "f=" line.
+     *
+     * Two lanes of xxHash64-style rounds over 64-bit words (then the remaining bytes),
+     * each finalized with the xxHash64 avalanche and keyed with the size hashed, so
+     * that the cache is not reused for another anthill while hashing stays about as
+     * fast as reading the file mapping.
+     *
+     * @param begin Pointer to the first character of the file content.
+     * @param end Pointer just past the last character of the file content.
+     * @return The size and hashes of the content.
+     */
+    static SourceDigest hashAnthill(const char* begin, const char* end);
+
+    /**
+     * @brief Gets the digest of the source file the cache was written from.
+     * @return The digest computed by hashAnthill().
+     */
+    const SourceDigest& getDigest() const;
+
+    /**
+     * @brief Gets the room count of the "r=" line.
+     * @return The declared number of rooms.
+     */
+    int getRoomCount() const;
+
+    /**
+     * @brief Gets the number of nodes, start and end rooms included.
+     * @return The node count.
+     */
+    int getNodeCount() const;
+
+    /**
+     * @brief Gets the number of arcs.
+     * @return The arc count.
+     */
+    int getArcCount() const;
+
+    /**
+     * @brief Gets the start node.
+     * @return Index of the start room "Sv".
+     */
+    int getStart() const;
+
+    /**
+     * @brief Gets the end node.
+     * @return Index of the end room "Sd".
+     */
+    int getEnd() const;
+
+    /**
+     * @brief Gets the capacity of each node.
+     * @return Pointer to the capacities in the mapping.
+     */
+    const int* getCapacities() const;
+
+    /**
+     * @brief Gets the first arc of each node, plus the total arc count.
+     * @return Pointer to the CSR offsets in the mapping.
+     */
+    const int* getOffsets() const;
+
+    /**
+     * @brief Gets the destination node of each arc.
+     * @return Pointer to the CSR neighbors in the mapping.
+     */
+    const int* getNeighbors() const;
+
+    /**
+     * @brief Gets the identifier of a node.
+     * @param node Index of the node.
+     * @return A copy of the identifier.
+     */
+    std::string getRoomId(int node) const;
+
+private:
+    MappedFile file;            ///< Mapping of the cache file.
+    SourceDigest digest;        ///< Digest of the source file.
+    int room_count;             ///< Room count of the "r=" line.
+    int node_count;             ///< Number of nodes.
+    int arc_count;              ///< Number of arcs.
+    int start;                  ///< Index of the start node.
+    int end;                    ///< Index of the end node.
+    const int* capacities;      ///< Capacity of each node, in the mapping.
+    const int* offsets;         ///< CSR offsets, in the mapping.
+    const int* neighbors;       ///< CSR neighbors, in the mapping.
+    const uint32_t* id_offsets; ///< First character of each identifier, in the mapping.
+    const char* ids;            ///< Concatenated identifiers, in the mapping.
+};
+
+#endif //GRAPHCACHE_H
@@ -0,0 +1,87 @@
+/**
+ * @file GraphReduction.h
+ * @brief Header file defining the reduction of an anthill graph before the path search
+ */
+
+#ifndef GRAPHREDUCTION_H
+#define GRAPHREDUCTION_H
+
+#include <vector>
+#include "Graph.h"
+#include "PathEnumerator.h"
+
+/**
+ * @class ReducedGraph
+ * @brief Smaller graph with the same simple paths between the start and end rooms.
+ *
+ * Two reductions are applied to the graph of the anthill:
+ * - Rooms that cannot lie on any simple path from the start room to the end room
+ *   (dead ends and side chambers) are removed. They are the rooms outside the
+ *   biconnected block holding a virtual tunnel between the start and end rooms.
+ * - Each corridor, a chain of remaining rooms with exactly two neighbors, becomes a
+ *   single node whose capacity is the smallest capacity of its rooms.
+ *
+ * The arcs of every node keep the order of the original graph, so a search on the
+ * reduced graph finds the paths in the same order as on the original one.
+ * Paths found are expanded back to the original rooms by expand().
+ */
+class ReducedGraph {
+public:
+    /**
+     * @brief Reduces a graph for the paths between two rooms.
+     * @param graph Graph of the anthill.
+     * @param start Index of the start room in the graph.
+     * @param end Index of the end room in the graph.
+     */
+    ReducedGraph(const Graph& graph, int start, int end);
+
+    /**
+     * @brief Gets the reduced graph.
+     * @return The reduced graph, to search instead of the original one.
+     */
+    const Graph& getGraph() const;
+
+    /**
+     * @brief Gets the node of the start room in the reduced graph.
+     * @return Index of the node.
+     */
+    int getSource() const;
+
+    /**
+     * @brief Gets the node of the end room in the reduced graph.
+     * @return Index of the node.
+     */
+    int getTarget() const;
+
+    /**
+     * @brief Gets the number of original rooms a node stands for.
+     * @param node Index of the node in the reduced graph.
+     * @return 1 for a room, the number of rooms of a corridor.
+     */
+    int getRoomCount(int node) const;
+
+    /**
+     * @brief Replaces the nodes of paths of the reduced graph by the original rooms.
+     * @param paths Paths found in the reduced graph.
+     * @param expanded Buffer receiving the same paths through the original rooms.
+     */
+    void expand(const PathBuffer& paths, PathBuffer& expanded) const;
+
+private:
+    /**
+     * @brief Marks the rooms lying on at least one simple path from the source to the target.
+     * @return Whether each room of the original graph is kept.
+     */
+    std::vector<bool> findUsefulRooms() const;
+
+    const Graph& original;              ///< Graph of the anthill.
+    int original_source;                ///< Index of the start room in the original graph.
+    int original_target;                ///< Index of the end room in the original graph.
+    Graph reduced;                      ///< Graph of the remaining rooms and corridors.
+    std::vector<std::vector<int>> rooms;   ///< Original rooms of each node, in corridor order.
+    std::vector<int> entrance;          ///< Node next to the first room of each corridor, -1 for rooms.
+    int source;                         ///< Node of the start room.
+    int target;                         ///< Node of the end room.
+};
+
+#endif //GRAPHREDUCTION_H
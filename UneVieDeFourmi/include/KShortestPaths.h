@@ -0,0 +1,167 @@
+/**
+ * @file KShortestPaths.h
+ * @brief Header file defining a lazy generator of simple paths in the order used by Anthill::sortAllPaths
+ */
+
+#ifndef KSHORTESTPATHS_H
+#define KSHORTESTPATHS_H
+
+#include <functional>
+#include <queue>
+#include <set>
+#include <utility>
+#include <vector>
+#include "Deadline.h"
+#include "Graph.h"
+
+/**
+ * @class KShortestPaths
+ * @brief Yields the simple paths between two rooms on demand, best first.
+ *
+ * Paths come out ordered by minimum capacity (descending), then by length
+ * (ascending), which is the order of Anthill::sortAllPaths, without ever
+ * materializing the whole path set.
+ *
+ * A single run of Yen's k-shortest simple paths algorithm produces them, Yen's
+ * heap being ordered by (minimum capacity, length) instead of length alone. The
+ * spur search of a root returns its best completion in that order: the highest
+ * capacity threshold still joining the target from the spur room, found by binary
+ * search over the distinct capacities, then the shortest path over the rooms of at
+ * least that capacity. Every path is therefore found once, whatever its capacity,
+ * and memory grows with the number of paths pulled.
+ *
+ * A length limit can be lowered between calls (limitLength()): the spur searches
+ * then only return completions within the limit, and a queued candidate found
+ * before the limit was lowered is replaced by the best completion of its root that
+ * fits, so no path within the limit is lost.
+ *
+ * A generator given a deadline checks it before each spur search and produces no
+ * more paths once it expires. The search of the first path is never stopped, so a
+ * path is produced whenever one exists.
+ */
+class KShortestPaths {
+public:
+    /**
+     * @brief Prepares the generator.
+     * @param graph Graph to search.
+     * @param source Index of the room every path starts from.
+     * @param target Index of the room every path ends at.
+     */
+    KShortestPaths(const Graph& graph, int source, int target);
+
+    /**
+     * @brief Produces the next path.
+     * @param rooms Vector receiving the room indices of the path, source and target included.
+     * @param bottleneck Receives the minimum capacity of the path.
+     * @return False once every path was produced, or once the deadline expired.
+     */
+    bool next(std::vector<int>& rooms, int& bottleneck);
+
+    /**
+     * @brief Stops the generator when a deadline expires.
+     * @param deadline Deadline checked before each spur search, which must outlive the generator (none if null).
+     */
+    void setDeadline(const Deadline* deadline);
+
+    /**
+     * @brief Checks if the deadline stopped the generator.
+     * @return true if next() returned false before every path was produced.
+     */
+    bool wasInterrupted() const;
+
+    /**
+     * @brief Limits the length of the paths produced from now on.
+     *
+     * Useful once a path of some length is too long to help: the following calls
+     * to next() still produce every shorter path, in the same order.
+     *
+     * @param max_length Largest number of tunnels of a path, no larger than the previous limit.
+     */
+    void limitLength(int max_length);
+
+private:
+    /**
+     * @brief Candidate path waiting in Yen's heap.
+     */
+    struct Candidate {
+        std::vector<int> rooms;   ///< Room indices of the path.
+        int bottleneck;           ///< Minimum capacity of the path.
+        size_t spur;              ///< Position of the spur room, the rooms before it being the root.
+
+        bool operator>(const Candidate& other) const {
+            // Higher minimum capacities first, then shorter paths, then a fixed order
+            if (bottleneck != other.bottleneck) return bottleneck < other.bottleneck;
+            if (rooms.size() != other.rooms.size()) return rooms.size() > other.rooms.size();
+            return rooms > other.rooms;
+        }
+    };
+
+    /**
+     * @brief Node of the prefix tree of the accepted paths.
+     */
+    struct Prefix {
+        std::vector<std::pair<int, int>> next;  ///< Room following the prefix and its node, per accepted continuation.
+    };
+
+    /**
+     * @brief Finds the best completion of a root within the length limit.
+     *
+     * The rooms of the root before the spur room are banned, and so are the arcs
+     * from the spur room to the next room of every accepted path sharing the root,
+     * read from the prefix tree.
+     *
+     * @param path Path whose first spur + 1 rooms are the root.
+     * @param spur Position of the spur room in path.
+     * @param candidate Receives the completed path, its minimum capacity and spur.
+     * @return True if a completion was found.
+     */
+    bool deviate(const std::vector<int>& path, size_t spur, Candidate& candidate);
+
+    /**
+     * @brief Breadth-first search for a shortest path over the rooms of a minimum capacity.
+     *
+     * Rooms stamped in the banned array and arcs from the spur room to banned_next
+     * rooms are avoided.
+     *
+     * @param from Index of the room the path starts from.
+     * @param minimum Smallest capacity of the rooms used.
+     * @param path Vector receiving the rooms from "from" to the target.
+     * @return True if a path was found.
+     */
+    bool shortestPath(int from, int minimum, std::vector<int>& path);
+
+    /**
+     * @brief Pushes the deviations of the last accepted path into the candidate heap.
+     */
+    void addDeviations();
+
+    /**
+     * @brief Checks the deadline before a spur search.
+     * @return true (and the generator is interrupted) once the deadline expired.
+     */
+    bool expired();
+
+    const Graph& graph;                     ///< Graph searched.
+    int source;                             ///< Index of the start room.
+    int target;                             ///< Index of the destination room.
+    std::vector<int> tiers;                 ///< Distinct capacities, from the lowest to the highest.
+    int max_length;                         ///< Largest number of tunnels of the paths produced.
+    bool started;                           ///< Whether the shortest path was queued.
+    bool pending_deviations;                ///< Whether the deviations of the last accepted path are missing.
+    const Deadline* deadline;               ///< Deadline of the generator, null if unlimited.
+    bool interrupted;                       ///< Whether the deadline stopped the generator.
+
+    std::vector<int> last;                  ///< Path produced last.
+    std::vector<Prefix> prefixes;           ///< Prefix tree of the paths produced, rooted at the source.
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> candidates; ///< Yen's heap.
+    std::set<std::vector<int>> known;       ///< Paths accepted or queued.
+
+    std::vector<unsigned> banned;           ///< Stamp of the rooms removed for the current root.
+    std::vector<int> banned_next;           ///< Rooms that cannot follow the spur room.
+    std::vector<unsigned> seen;             ///< Stamp of the rooms reached by the current search.
+    std::vector<int> parent;                ///< Predecessor of each room reached by the current search.
+    unsigned root_stamp;                    ///< Stamp of the current root.
+    unsigned search_stamp;                  ///< Stamp of the current search.
+};
+
+#endif //KSHORTESTPATHS_H
@@ -0,0 +1,79 @@
+/**
+ * @file LowerBound.h
+ * @brief Header file defining the lower bound on the number of steps of any schedule
+ */
+
+#ifndef LOWERBOUND_H
+#define LOWERBOUND_H
+
+#include "Graph.h"
+#include "RoomFlow.h"
+
+/**
+ * @class LowerBound
+ * @brief Number of steps no schedule can beat, to recognise optimal solutions.
+ *
+ * Two properties of the anthill limit every schedule:
+ * - The smallest cut of rooms between the start and end rooms, weighted by their
+ *   capacities: at most c ants are in the rooms of a cut of capacity c at the end of
+ *   a step, and every ant has to stop in one of them, so at most c ants go through
+ *   the cut per step. It is the value of the RoomFlow of the anthill.
+ * - The shortest path, of L tunnels: no ant reaches the end room before step L.
+ *
+ * The last of f ants goes through the cut at step ceil(f / c) at the earliest and
+ * reaches the end room L - 1 steps later at least, so every schedule takes at least
+ * ceil(f / c) + L - 1 steps.
+ */
+class LowerBound {
+public:
+    /**
+     * @brief Computes the bound for bringing ants from one room to another.
+     * @param graph Graph of the anthill, with the room capacities.
+     * @param source Index of the room every ant starts from.
+     * @param sink Index of the room every ant must reach.
+     * @param ant_count Number of ants.
+     */
+    LowerBound(const Graph& graph, int source, int sink, int ant_count);
+
+    /**
+     * @brief Computes the bound from a flow already computed.
+     *
+     * The smallest cut is unknown when the deadline of the flow stopped it, and so is
+     * the bound.
+     *
+     * @param graph Graph of the anthill, with the room capacities.
+     * @param source Index of the room every ant starts from.
+     * @param sink Index of the room every ant must reach.
+     * @param ant_count Number of ants.
+     * @param flow RoomFlow between the same rooms for the same number of ants.
+     */
+    LowerBound(const Graph& graph, int source, int sink, int ant_count, const RoomFlow& flow);
+
+    /**
+     * @brief Gets the capacity of the smallest cut of rooms between the start and end rooms.
+     * @return Ants going through the cut per step, at most the number of ants (the
+     *         start and end rooms are never cut), 0 if the end room cannot be reached
+     *         or the cut is unknown.
+     */
+    long long getMinimumCut() const;
+
+    /**
+     * @brief Gets the length of the shortest path from the start room to the end room.
+     * @return Number of tunnels of the path, -1 if the end room cannot be reached.
+     */
+    int getShortestLength() const;
+
+    /**
+     * @brief Gets the number of steps no schedule can beat.
+     * @return ceil(f / c) + L - 1, 0 without ants, -1 if the end room cannot be reached
+     *         or the cut is unknown.
+     */
+    int getSteps() const;
+
+private:
+    long long minimum_cut;      ///< Capacity of the smallest cut of rooms.
+    int shortest_length;        ///< Number of tunnels of the shortest path.
+    int steps;                  ///< Combined lower bound on the number of steps.
+};
+
+#endif //LOWERBOUND_H
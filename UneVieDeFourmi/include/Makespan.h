@@ -0,0 +1,74 @@
+/**
+ * @file Makespan.h
+ * @brief Header file defining the closed-form number of steps of a set of room-disjoint paths
+ */
+
+#ifndef MAKESPAN_H
+#define MAKESPAN_H
+
+#include <cstddef>
+#include <queue>
+#include <utility>
+#include <vector>
+#include "Path.h"
+
+/**
+ * @brief Computes the number of steps needed to bring the ants through room-disjoint paths.
+ *
+ * A path of L tunnels whose smallest room holds c ants delivers c ants per step from
+ * step L on, so within T steps it brings c * (T - L + 1) ants. The ants are spread
+ * over the paths like water filling them, the shortest paths first: the result is
+ * the smallest T for which the paths bring every ant, found in O(p log p) for p
+ * paths. Paths longer than T receive no ant.
+ *
+ * @param paths Room-disjoint paths the ants follow
+ * @param path_count Number of paths used, taken from the beginning of paths
+ * @param ant_count Number of ants to bring to the end room
+ * @param quotas Receives the number of ants to send through each path
+ * @return Number of steps required to move all ants to the end room, or -1 if the
+ *         paths cannot carry any ant
+ */
+int computeMakespan(const std::vector<Path>& paths, size_t path_count, int ant_count,
+                    std::vector<int>& quotas);
+
+/**
+ * @class MakespanEvaluator
+ * @brief Updates the closed-form number of steps of room-disjoint paths added one at a time.
+ *
+ * Gives the same result as computeMakespan on the paths added so far, but each new
+ * path only updates the previous result: adding a path can only lower the number of
+ * steps, so a path too long to be used never becomes useful again. The paths in use
+ * are kept in a heap by length, and the longest ones are dropped while they cannot
+ * bring an ant in time. Adding a path costs O(log p).
+ */
+class MakespanEvaluator {
+public:
+    /**
+     * @brief Prepares an evaluator without any path.
+     * @param ant_count Number of ants to bring to the end room.
+     */
+    explicit MakespanEvaluator(int ant_count);
+
+    /**
+     * @brief Adds a path, room-disjoint from the previous ones.
+     * @param path Path to add.
+     * @return Number of steps required to move all ants through the paths added so far,
+     *         or -1 if they cannot carry any ant.
+     */
+    int addPath(const Path& path);
+
+    /**
+     * @brief Gets the number of steps with the paths added so far.
+     * @return Number of steps required to move all ants, or -1 if the paths cannot carry any ant.
+     */
+    int getMakespan() const;
+
+private:
+    int ant_count;          ///< Number of ants to bring to the end room.
+    long long capacity;     ///< Sum of the bottlenecks of the paths in use.
+    long long delay;        ///< Sum of c * (L - 1) over the paths in use.
+    long long makespan;     ///< Number of steps with the paths in use, -1 without any.
+    std::priority_queue<std::pair<long long, int>> used;   ///< Length and bottleneck of the paths in use.
+};
+
+#endif //MAKESPAN_H
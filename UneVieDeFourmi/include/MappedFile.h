@@ -0,0 +1,65 @@
+/**
+ * @file MappedFile.h
+ * @brief Header file defining a read-only memory mapping of a whole file
+ */
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @class MappedFile
+ * @brief Maps a file read-only into memory for the lifetime of the object.
+ *
+ * The content is exposed as a contiguous range of characters, so parsers can
+ * scan it directly without copying lines into strings.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Maps a file into memory.
+     * @param filename The path to the file to map.
+     * @throws std::runtime_error if the file cannot be opened or mapped.
+     */
+    explicit MappedFile(const std::string& filename);
+
+    /**
+     * @brief Unmaps the file.
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Gets the first character of the file.
+     * @return Pointer to the beginning of the mapped content.
+     */
+    const char* begin() const;
+
+    /**
+     * @brief Gets the position just past the last character of the file.
+     * @return Pointer to the end of the mapped content.
+     */
+    const char* end() const;
+
+    /**
+     * @brief Gets the size of the file.
+     * @return The number of bytes mapped.
+     */
+    size_t size() const;
+
+private:
+    const char* data;        ///< Beginning of the mapped content (nullptr for an empty file).
+    size_t length;           ///< Number of bytes mapped.
+#ifdef _WIN32
+    void* file_handle;       ///< Handle of the opened file.
+    void* mapping_handle;    ///< Handle of the file mapping object.
+#else
+    int descriptor;          ///< Descriptor of the opened file.
+#endif
+};
+
+#endif //MAPPEDFILE_H
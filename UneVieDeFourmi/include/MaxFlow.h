@@ -0,0 +1,104 @@
+/**
+ * @file MaxFlow.h
+ * @brief Header file defining a maximum flow solver (Dinic's algorithm) on a directed network
+ */
+
+#ifndef MAXFLOW_H
+#define MAXFLOW_H
+
+#include <cstddef>
+#include <vector>
+#include "Deadline.h"
+
+/**
+ * @class MaxFlow
+ * @brief Computes a maximum flow between two nodes of a directed network.
+ *
+ * Nodes are dense integer indices. Every added edge is stored together with its
+ * reverse residual edge, so the flow carried by an edge can be read back after
+ * the computation. The implementation uses Dinic's algorithm with an explicit
+ * stack, so deep networks cannot overflow the call stack.
+ *
+ * A computation given a deadline stops between two phases once it expires, keeping
+ * the flow already pushed.
+ */
+class MaxFlow {
+public:
+    /** @brief Capacity used for edges that must never limit the flow */
+    static const long long INFINITE_CAPACITY;
+
+    /**
+     * @brief Constructs an empty network.
+     * @param node_count Number of nodes in the network.
+     */
+    explicit MaxFlow(int node_count);
+
+    /**
+     * @brief Adds a directed edge to the network.
+     * @param from Index of the origin node.
+     * @param to Index of the destination node.
+     * @param capacity Maximum flow the edge can carry.
+     * @return Identifier of the edge, usable with getFlow().
+     */
+    int addEdge(int from, int to, long long capacity);
+
+    /**
+     * @brief Pushes as much flow as possible from source to sink.
+     * @param source Index of the source node.
+     * @param sink Index of the sink node.
+     * @param limit Upper bound on the flow to push.
+     * @return The value of the flow found.
+     */
+    long long run(int source, int sink, long long limit = INFINITE_CAPACITY);
+
+    /**
+     * @brief Stops the computation when a deadline expires.
+     * @param deadline Deadline checked between two phases, which must outlive the computation (none if null).
+     */
+    void setDeadline(const Deadline* deadline);
+
+    /**
+     * @brief Checks if the last computation was stopped by its deadline.
+     * @return true if the flow found may not be maximum.
+     */
+    bool wasInterrupted() const;
+
+    /**
+     * @brief Gets the flow currently carried by an edge.
+     * @param edge Identifier returned by addEdge().
+     * @return The flow on the edge.
+     */
+    long long getFlow(int edge) const;
+
+    /**
+     * @brief Gets the number of nodes in the network.
+     * @return The node count.
+     */
+    int getNodeCount() const;
+
+private:
+    /**
+     * @brief Edge of the residual network.
+     */
+    struct Edge {
+        int to;              ///< Destination node.
+        long long capacity;  ///< Remaining residual capacity.
+        long long flow;      ///< Flow currently carried.
+    };
+
+    /**
+     * @brief Computes BFS levels from the source in the residual network.
+     * @return True if the sink is reachable.
+     */
+    bool buildLevels(int source, int sink);
+
+    int node_count;                             ///< Number of nodes.
+    std::vector<Edge> edges;                    ///< Edges, each followed by its reverse edge.
+    std::vector<std::vector<int>> adjacency;    ///< Edge identifiers leaving each node.
+    std::vector<int> level;                     ///< BFS level of each node in the current phase.
+    std::vector<size_t> next_edge;              ///< Next edge to try for each node in the current phase.
+    const Deadline* deadline;                   ///< Deadline of the computation, null if unlimited.
+    bool interrupted;                           ///< Whether the deadline stopped the last computation.
+};
+
+#endif //MAXFLOW_H
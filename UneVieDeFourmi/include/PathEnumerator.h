@@ -0,0 +1,222 @@
+/**
+ * @file PathEnumerator.h
+ * @brief Header file defining the enumeration of all simple paths between two rooms of a graph
+ */
+
+#ifndef PATHENUMERATOR_H
+#define PATHENUMERATOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Deadline.h"
+#include "Graph.h"
+#include "ThreadPool.h"
+
+/**
+ * @brief Flat storage of a list of paths given as room indices.
+ *
+ * The rooms of all paths are concatenated in a single array; path i occupies
+ * rooms[begins[i]] to rooms[begins[i + 1] - 1]. Appending a path does not
+ * allocate once the arrays have grown.
+ */
+struct PathBuffer {
+    /** @brief Room indices of all paths, one path after the other */
+    std::vector<int> rooms;
+
+    /** @brief Position of the first room of each path, followed by the total room count */
+    std::vector<size_t> begins = std::vector<size_t>(1, 0);
+
+    /** @brief Minimum room capacity of each path */
+    std::vector<int> bottlenecks;
+
+    /**
+     * @brief Gets the number of paths stored.
+     * @return The path count.
+     */
+    size_t size() const { return bottlenecks.size(); }
+
+    /**
+     * @brief Removes all paths, keeping the allocated memory.
+     */
+    void clear() {
+        rooms.clear();
+        begins.assign(1, 0);
+        bottlenecks.clear();
+    }
+
+    /**
+     * @brief Appends all paths of another buffer.
+     * @param other Buffer whose paths are copied after the current ones.
+     */
+    void append(const PathBuffer& other) {
+        size_t shift = rooms.size();
+        rooms.insert(rooms.end(), other.rooms.begin(), other.rooms.end());
+        for (size_t i = 1; i < other.begins.size(); i++) {
+            begins.push_back(other.begins[i] + shift);
+        }
+        bottlenecks.insert(bottlenecks.end(), other.bottlenecks.begin(), other.bottlenecks.end());
+    }
+};
+
+/**
+ * @class PathEnumerator
+ * @brief Enumerates every simple path from a source room to a target room.
+ *
+ * The search is a depth-first search driven by an explicit stack of arc cursors,
+ * so deep graphs cannot overflow the call stack. Rooms on the current path are
+ * tracked in a bitset reused between searches, and every path found is appended
+ * to a shared PathBuffer. Paths are produced in the order of a recursive search
+ * following the arcs of each room in graph order.
+ *
+ * The search can also run on a ThreadPool: a worker exploring a subtree hands the
+ * untried arcs of its shallowest room to the pool whenever another worker is idle.
+ * Each piece of work remembers the arcs leading to it, and the pieces are merged
+ * in that order, so the result is the same as the sequential search.
+ *
+ * Only induced paths are produced: a path holding two non-consecutive rooms joined
+ * by a tunnel is skipped, since cutting through that tunnel gives a shorter path
+ * over a subset of its rooms, with the same or a larger bottleneck. Paths can also
+ * be limited in length, branches being cut as soon as the distance left to the
+ * target (found by a reverse search) makes them too long.
+ *
+ * A search given a deadline stops once it expires, keeping the paths already found.
+ * So does a search whose paths reach the room limit (DEFAULT_MAXIMUM_ROOMS unless
+ * limitRooms() changes it), which bounds the memory of the paths stored.
+ */
+class PathEnumerator {
+public:
+    /** @brief Maximum number of rooms of the paths produced, unless changed (about 200 MB once stored) */
+    static const size_t DEFAULT_MAXIMUM_ROOMS;
+
+    /**
+     * @brief Prepares an enumerator on a graph.
+     * @param graph Graph to search.
+     * @param source Index of the room every path starts from.
+     * @param target Index of the room every path ends at.
+     * @param lengths Number of tunnels crossed to enter and go through each node
+     *        (1 for every node if empty), for graphs whose nodes stand for corridors.
+     */
+    PathEnumerator(const Graph& graph, int source, int target,
+                   const std::vector<int>& lengths = std::vector<int>());
+
+    /**
+     * @brief Gets the length of the shortest path from the source to the target.
+     * @return Number of tunnels of the shortest path, -1 if there is no path.
+     */
+    int getShortestLength() const;
+
+    /**
+     * @brief Skips the paths longer than a given length.
+     * @param length Maximum number of tunnels of the paths produced.
+     */
+    void limitLength(int length);
+
+    /**
+     * @brief Stops the search once the paths found hold a given number of rooms.
+     * @param rooms Maximum number of rooms of all the paths produced, counted along
+     *        the tunnels of the corridor nodes.
+     */
+    void limitRooms(size_t rooms);
+
+    /**
+     * @brief Stops the search when a deadline expires.
+     * @param deadline Deadline checked during the search, which must outlive it (none if null).
+     */
+    void setDeadline(const Deadline* deadline);
+
+    /**
+     * @brief Checks if the last search was stopped by its deadline.
+     * @return true if some paths may be missing from the output.
+     */
+    bool wasInterrupted() const;
+
+    /**
+     * @brief Checks if the last search was stopped by the room limit.
+     * @return true if some paths may be missing from the output.
+     */
+    bool wasTruncated() const;
+
+    /**
+     * @brief Appends every simple path from the source to the target.
+     * @param output Buffer receiving the paths found.
+     */
+    void enumerate(PathBuffer& output);
+
+    /**
+     * @brief Appends every simple path from the source to the target, searching in parallel.
+     * @param pool Workers sharing the search.
+     * @param output Buffer receiving the paths found, in the same order as enumerate().
+     */
+    void enumerate(ThreadPool& pool, PathBuffer& output);
+
+private:
+    /**
+     * @brief Position of the search in one room of the current path.
+     */
+    struct Frame {
+        int room;         ///< Index of the room.
+        int next_arc;     ///< Next arc of the room to follow.
+        int arc_end;      ///< Position just past the last arc of the room to follow.
+        int bottleneck;   ///< Minimum capacity of the path up to this room.
+        int length;       ///< Number of tunnels of the path up to this room.
+    };
+
+    /**
+     * @brief Subtree of the search explored by one worker.
+     */
+    struct Task {
+        std::vector<int> prefix;   ///< Rooms leading to the subtree root, excluded.
+        std::vector<int> route;    ///< Arcs taken from the source, then the first arc of the subtree.
+        Frame root;                ///< Root room of the subtree with the range of arcs to follow.
+        PathBuffer output;         ///< Paths found in the subtree.
+    };
+
+    /**
+     * @brief Search state reused by the tasks run on one thread.
+     */
+    struct Scratch {
+        std::vector<uint64_t> visited;   ///< Bitset of the rooms on the current path.
+        std::vector<Frame> stack;        ///< Rooms of the current path with their search positions.
+    };
+
+    /**
+     * @brief Explores a subtree, splitting off work for idle workers when a pool is given.
+     */
+    void explore(Task& task, PathBuffer& output, Scratch& scratch, ThreadPool* pool);
+
+    /**
+     * @brief Queues a task on the pool and records it for the final merge.
+     */
+    void schedule(std::unique_ptr<Task> task, ThreadPool& pool);
+
+    /**
+     * @brief Checks if a room can extend the current path, ending at a given room.
+     * @return true if the path stays induced and short enough.
+     */
+    bool canExtend(const Scratch& scratch, const Frame& frame, int next) const;
+
+    static bool isVisited(const Scratch& scratch, int room) { return (scratch.visited[room >> 6] >> (room & 63)) & 1; }
+    static void setVisited(Scratch& scratch, int room) { scratch.visited[room >> 6] |= uint64_t(1) << (room & 63); }
+    static void clearVisited(Scratch& scratch, int room) { scratch.visited[room >> 6] &= ~(uint64_t(1) << (room & 63)); }
+
+    const Graph& graph;                          ///< Graph searched.
+    int source;                                  ///< Index of the start room.
+    int target;                                  ///< Index of the destination room.
+    std::vector<int> lengths;                    ///< Tunnels crossed to enter and go through each room.
+    std::vector<int> to_target;                  ///< Fewest tunnels from each room to the target, -1 if none.
+    int max_length;                              ///< Maximum number of tunnels of a path.
+    size_t max_rooms;                            ///< Maximum number of rooms of all the paths.
+    std::atomic<size_t> room_count;              ///< Rooms of the paths produced by the current search.
+    const Deadline* deadline;                    ///< Deadline of the search, null if unlimited.
+    std::atomic<bool> interrupted;               ///< Whether the deadline stopped the search.
+    std::atomic<bool> truncated;                 ///< Whether the room limit stopped the search.
+    std::vector<Scratch> scratches;              ///< Search state of each worker thread.
+    std::mutex tasks_mutex;                      ///< Protects tasks.
+    std::vector<std::unique_ptr<Task>> tasks;    ///< Every task of the parallel search.
+};
+
+#endif //PATHENUMERATOR_H
@@ -5,8 +5,8 @@
 #include <string>
 #include <deque>
 #include <vector>
-#include <set>
 #include "Ant.h"
+#include "Graph.h"
 #include "Path.h"
 
 
@@ -14,19 +14,29 @@ class Ant;
 
 /**
  * @class Room
- * @brief Represents a room in the anthill that can contain ants and link to child rooms.
+ * @brief Represents a room in the anthill that can contain ants.
  *
- * Each room has a unique identifier, a maximum number of ants that can be stored, a current number of ants, a list of ants, and a list of child rooms.
+ * A room is a view over one node of the anthill's Graph: its capacity, its number
+ * of ants and its connections to other rooms are stored in the graph's contiguous
+ * arrays. The room itself keeps its identifier and the queue of ants inside it.
+ *
+ * Ants can also be held as a plain count, without Ant objects: the start and end
+ * rooms hold their ants that way, so that large colonies need no memory per ant.
+ *
+ * Ants move between rooms by batches: transferAnts() moves the ants leaving through
+ * a tunnel in one operation. An ant moves at most once per movement epoch; rather
+ * than stamping every ant, a room remembers how many ants entered it during the
+ * last epoch they arrived, which are the last ones of its queue.
  */
 class Room {
 public:
     /**
      * @brief Constructs a Room.
      * @param id Identifier for the room.
-     * @param size_max Maximum number of ants the room can hold.
-     * @param ants Initial number of ants in the room (default is 0).
+     * @param graph Graph of the anthill storing the room's capacity, ants count and connections.
+     * @param index Index of the room's node in the graph, interned from the identifier.
      */
-    Room(const std::string& id, int size_max, int ants = 0);
+    Room(const std::string& id, Graph& graph, int index);
 
     /**
      * @brief Destroys the Room.
@@ -36,34 +46,15 @@ public:
 
     /**
      * @brief Returns the ID of the room.
-     * @return Room ID as a string.
-     */
-    std::string getId() const;
-
-    /**
-     * @brief Gets the collection of ants currently in the room.
-     * @return A double-ended queue containing pointers to all ants in the room.
-     *         The queue maintains the order in which ants entered the room (FIFO).
-     */
-    std::deque<Ant*> getAnts() const;
-
-    /**
-     * @brief Gets the first ant in the room.
-     * @return Pointer to the first ant, or nullptr if the room is empty.
-     */
-    Ant* getFirstAnt() const;
-
-    /**
-     * @brief Adds a child room as a connection.
-     * @param child Pointer to the child room.
+     * @return Constant reference to the room ID.
      */
-    void addChildNode(Room* child);
+    const std::string& getId() const;
 
     /**
-     * @brief Checks if the room contains any ants.
-     * @return True if least one ant is present, false otherwise.
+     * @brief Returns the dense index of the room in its anthill.
+     * @return Index of the room, between 0 and the number of rooms - 1.
      */
-    bool hasAnts() const;
+    int getIndex() const;
 
     /**
      * @brief Gets the current number of ants present in the room.
@@ -75,68 +66,73 @@ public:
      * @brief Gets the maximum capacity of ants that can be present in the room simultaneously.
      * @return An integer representing the maximum number of ants the room can hold.
      */
-    int getCapacity();
+    int getCapacity() const;
 
     /**
-     * @brief Checks if the room can accept a new ant.
-     * @return True if the number of ants is lower than the maximum capacity.
+     * @brief Adds or removes ants held as a count, without Ant objects.
+     * @param count Number of ants to add, negative to remove ants.
      */
-    bool canAcceptAnt() const;
+    void addAntCount(int count);
 
     /**
-     * @brief Displays the room's information and its child rooms recursively.
-     * @param depth Indentation level for pretty-printing the hierarchy.
-     * @param visited A set to avoid printing the same room multiple times.
+     * @brief Gets the number of ants that can leave the room during an epoch.
+     * @param epoch Current movement epoch.
+     * @return Number of ants in the queue that did not enter the room during the epoch.
      */
-    void display(int depth, std::set<const Room*>& visited) const;
+    int getMovableAnts(unsigned epoch) const;
 
     /**
-     * @brief Adds an ant to tthe room.
-     * @param ant Pointer to the ant to be added.
-     */
-    void addAnt(Ant* ant);
-
-    /**
-     * @brief Removes the first ant from the room.
+     * @brief Moves ants from the front of the queue to the back of another room's queue.
+     *
+     * At most count ants move, only ants that can leave during the epoch, and no more
+     * than the destination has room for. The ants are moved in one batch and the
+     * destination records their arrival once; nothing is displayed.
+     *
+     * @param destination Room the ants enter.
+     * @param count Maximum number of ants to move.
+     * @param epoch Current movement epoch.
+     * @param moved Receives the ants moved, in queue order, if not null.
+     * @return Number of ants moved.
      */
-    void removeAnt();
+    int transferAnts(Room& destination, int count, unsigned epoch, std::vector<Ant*>* moved = nullptr);
 
     /**
-     * @brief Recursively finds all possible paths from this room to a target room.
+     * @brief Removes ants from the front of the queue, handing them over to the caller.
      *
-     * @param targetRoom Pointer to the destination room
-     * @param visited Set of already visited rooms to avoid cycles
-     * @param path Path object containing the current path being built and its minimum capacity
+     * Used when the ants enter a room holding ants as a count.
      *
-     * @return A vector containing all valid paths found to the target room
-     *
-     * @details This method uses a Depth-First Search (DFS) algorithm to:
-     *          - Explore all possible paths to the target room
-     *          - Update the minimum capacity of each path
-     *          - Avoid cycles by keeping track of visited rooms
+     * @param count Maximum number of ants to remove, only ants that can leave during the epoch.
+     * @param epoch Current movement epoch.
+     * @param taken Receives the ants removed, in queue order.
+     * @return Number of ants removed.
      */
-    std::vector<Path> findAllPaths(Room* targetRoom, std::set<const Room*>& visited, Path path);
+    int takeAnts(int count, unsigned epoch, std::vector<Ant*>& taken);
 
     /**
-     * @brief Convenience overload to find all possible paths to a target room.
-     *
-     * @param targetRoom Pointer to the destination room
-     * @param visited Set of already visited rooms to avoid cycles
+     * @brief Adds ants at the back of the queue, arrived during an epoch.
      *
-     * @return A vector containing all valid paths found to the target room
+     * Used when the ants leave a room holding ants as a count. The caller makes sure
+     * the room has enough space.
      *
-     * @details This is a wrapper method that initializes a new Path with the room's maximum capacity (ANTS_MAX) and delegates to the main findAllPaths implementation.
+     * @param arriving Ants entering the room, in queue order.
+     * @param epoch Current movement epoch.
      */
-    std::vector<Path> findAllPaths(Room* targetRoom, std::set<const Room*>& visited) {
-        return findAllPaths(targetRoom, visited, Path(ANTS_MAX));
-    }
+    void receiveAnts(const std::vector<Ant*>& arriving, unsigned epoch);
 
 private:
+    /**
+     * @brief Records ants entering the room during an epoch.
+     * @param count Number of ants entering.
+     * @param epoch Current movement epoch.
+     */
+    void recordArrivals(int count, unsigned epoch);
+
     std::string const id_room;         ///< Unique identifier for the room.
-    int const ANTS_MAX;                ///< Maximum number of ants the room can hold.
-    int ants_inside = 0;               ///< Current number of ants in the room.
+    Graph& graph;                      ///< Graph storing capacities, ants counts and connections.
+    int const index_room;              ///< Index of the room's node in the graph.
     std::deque<Ant*> ants;             ///< Queue of pointers to ants in the room.
-    std::vector<Room*> children;       ///< List of connected child rooms.
+    unsigned arrival_epoch;            ///< Last epoch during which ants entered the room.
+    int arrived;                       ///< Number of ants that entered during arrival_epoch.
 };
 
 #endif //ROOM_H
@@ -0,0 +1,70 @@
+/**
+ * @file RoomFlow.h
+ * @brief Header file defining the maximum flow of ants through the rooms of an anthill
+ */
+
+#ifndef ROOMFLOW_H
+#define ROOMFLOW_H
+
+#include <vector>
+#include "Deadline.h"
+#include "Graph.h"
+
+/**
+ * @class RoomFlow
+ * @brief Maximum number of ants crossing the anthill per step, with the paths carrying them.
+ *
+ * Each room is split into an entry and an exit node joined by an arc of its capacity,
+ * tunnels becoming uncapacitated arcs; the start and end rooms hold every ant and
+ * never limit the flow. Dinic's algorithm computes the maximum flow from the start
+ * room to the end room, bounded by the number of ants, which is then decomposed into
+ * paths of rooms.
+ *
+ * The flow is both the smallest cut of rooms used by LowerBound and the source of the
+ * max-flow candidate paths of an Anthill, which computes it once for both.
+ *
+ * A flow given a deadline stops between two phases of Dinic's algorithm once it
+ * expires: it is then not maximum, but its paths can still be used. It carries at
+ * least one ant whenever the end room can be reached.
+ */
+class RoomFlow {
+public:
+    /**
+     * @brief Computes the flow and its paths.
+     * @param graph Graph of the anthill, with the room capacities.
+     * @param source Index of the room every ant starts from.
+     * @param sink Index of the room every ant must reach.
+     * @param ant_count Number of ants, the largest flow searched.
+     * @param deadline Deadline of the computation, which must outlive it (none if null).
+     */
+    RoomFlow(const Graph& graph, int source, int sink, int ant_count, const Deadline* deadline = nullptr);
+
+    /**
+     * @brief Gets the value of the flow.
+     * @return Ants crossing the anthill per step, at most the number of ants.
+     */
+    long long getValue() const;
+
+    /**
+     * @brief Checks if the deadline stopped the computation.
+     * @return true if the flow may not be maximum.
+     */
+    bool wasInterrupted() const;
+
+    /**
+     * @brief Gets the paths of the flow.
+     *
+     * The flow is decomposed by repeatedly taking a shortest path carrying flow, after
+     * cancelling the flow sent both ways through a tunnel.
+     *
+     * @return Room indices of each path, the start and end rooms included.
+     */
+    const std::vector<std::vector<int>>& getPaths() const;
+
+private:
+    long long value;                        ///< Value of the flow.
+    bool interrupted;                       ///< Whether the deadline stopped the computation.
+    std::vector<std::vector<int>> paths;    ///< Decomposition of the flow into paths.
+};
+
+#endif //ROOMFLOW_H
@@ -0,0 +1,140 @@
+/**
+ * @file ScheduleStream.h
+ * @brief Header file defining the step-by-step generation of a solution, with run-length compression
+ */
+
+#ifndef SCHEDULESTREAM_H
+#define SCHEDULESTREAM_H
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+#include "Graph.h"
+#include "Path.h"
+#include "TimeExpandedScheduler.h"
+
+/**
+ * @brief Ants with consecutive numbers crossing one tunnel during a step.
+ *
+ * Ants are numbered from 1 in the order they leave the start room, like the
+ * identifiers "f1", "f2", ... of the displayed solution.
+ */
+struct AntMove {
+    int from;               ///< Index of the room left.
+    int to;                 ///< Index of the room entered.
+    long long first_ant;    ///< Number of the first ant moving.
+    long long ants;         ///< Number of ants moving: first_ant to first_ant + ants - 1.
+};
+
+/**
+ * @brief Consecutive steps repeating the same moves with shifted ant numbers.
+ *
+ * Step first_step + k, for k from 0 to repeat - 1, holds the moves of the run with
+ * k * shift added to every ant number.
+ */
+struct ScheduleRun {
+    long long first_step;           ///< Number of the first step of the run, from 1.
+    long long repeat;               ///< Number of steps of the run.
+    long long shift;                ///< Added to the ant numbers from one step to the next.
+    std::vector<AntMove> moves;     ///< Moves of the first step of the run.
+};
+
+/**
+ * @class ScheduleStream
+ * @brief Produces the moves of a solution one step at a time, on demand.
+ *
+ * The stream moves the ants exactly like Anthill::displayBestSolution, either along
+ * paths (greedily, with optional quotas) or by replaying a schedule of the
+ * TimeExpandedScheduler, but only keeps numbers: each room holds a queue of ranges of
+ * consecutive ant numbers. Its memory depends on the rooms and their capacities, not
+ * on the number of ants.
+ *
+ * Once the paths are filled, every step repeats the moves of the previous one, the
+ * ant numbers shifted by the ants leaving the start room per step. nextRun() merges
+ * such steps, so a solution reads as a fill phase, a steady state repeated many times
+ * and a drain phase.
+ */
+class ScheduleStream {
+public:
+    /**
+     * @brief Prepares the ants moving along paths.
+     * @param graph Graph of the anthill, with the room capacities.
+     * @param start Index of the start room.
+     * @param end Index of the end room.
+     * @param ant_count Number of ants, all in the start room.
+     * @param paths Paths the ants follow, processed in order at each step.
+     * @param quotas Number of ants sent through each path, or nullptr for no limit.
+     */
+    ScheduleStream(const Graph& graph, int start, int end, long long ant_count,
+                   const std::vector<Path>& paths, const std::vector<int>* quotas = nullptr);
+
+    /**
+     * @brief Prepares the ants moving according to a schedule.
+     * @param graph Graph of the anthill, with the room capacities.
+     * @param start Index of the start room.
+     * @param end Index of the end room.
+     * @param ant_count Number of ants, all in the start room.
+     * @param schedule Moves of each step, in the order they are carried out.
+     */
+    ScheduleStream(const Graph& graph, int start, int end, long long ant_count,
+                   const std::vector<std::vector<ScheduledMove>>& schedule);
+
+    /**
+     * @brief Produces the moves of the next step.
+     * @param moves Receives the moves, in the order they are displayed.
+     * @return false once every ant reached the end room or no ant can move.
+     */
+    bool next(std::vector<AntMove>& moves);
+
+    /**
+     * @brief Produces the next steps repeating the same moves.
+     * @param run Receives the steps, at least one.
+     * @return false once every ant reached the end room or no ant can move.
+     */
+    bool nextRun(ScheduleRun& run);
+
+    /**
+     * @brief Gets the number of steps produced so far.
+     * @return Number of the last step produced, 0 before the first one.
+     */
+    long long getStep() const;
+
+private:
+    /**
+     * @brief Ants with consecutive numbers waiting in a room.
+     */
+    struct Range {
+        long long first;    ///< Number of the first ant.
+        long long count;    ///< Number of ants.
+    };
+
+    /**
+     * @brief Moves ants through a tunnel, as many as allowed.
+     * @return Number of ants moved.
+     */
+    long long move(int from, int to, long long count, std::vector<AntMove>& moves);
+
+    /**
+     * @brief Checks if a step repeats the last step of a run, and by which shift.
+     */
+    static bool repeats(const ScheduleRun& run, const std::vector<AntMove>& moves, long long& shift);
+
+    const Graph& graph;                                         ///< Graph of the anthill.
+    int start;                                                  ///< Index of the start room.
+    int end;                                                    ///< Index of the end room.
+    long long ant_count;                                        ///< Number of ants.
+    const std::vector<Path>* paths;                             ///< Paths followed, null for a schedule.
+    const std::vector<std::vector<ScheduledMove>>* schedule;    ///< Schedule replayed, null for paths.
+    std::vector<long long> remaining;                           ///< Ants that may still take each path.
+    bool limited;                                               ///< Whether remaining applies.
+    std::vector<long long> occupancy;                           ///< Number of ants in each room.
+    std::vector<std::deque<Range>> queues;                      ///< Ants of each intermediate room, in order.
+    std::vector<long long> arrived;                             ///< Ants that entered each room during arrival_step.
+    std::vector<long long> arrival_step;                        ///< Last step during which ants entered each room.
+    long long released;                                         ///< Number of ants that left the start room.
+    long long step;                                             ///< Number of steps produced.
+    std::vector<AntMove> pending;                               ///< Step read ahead by nextRun.
+    bool has_pending;                                           ///< Whether pending holds a step.
+};
+
+#endif //SCHEDULESTREAM_H
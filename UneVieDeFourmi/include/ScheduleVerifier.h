@@ -0,0 +1,149 @@
+/**
+ * @file ScheduleVerifier.h
+ * @brief Header file defining the independent check of a solution against its anthill
+ */
+
+#ifndef SCHEDULEVERIFIER_H
+#define SCHEDULEVERIFIER_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "BinarySchedule.h"
+#include "Graph.h"
+
+/**
+ * @class ScheduleVerifier
+ * @brief Replays the moves of a solution and reports the first rule they break.
+ *
+ * Every ant starts in the start room. The moves of a step are applied in the order
+ * they are given, as the solver applies them, and each move must:
+ * - be the first move of its ant during the step,
+ * - leave the room the ant is in, through a tunnel of the anthill,
+ * - enter a room that still has space for one more ant.
+ * Steps follow each other from 1, and after the last one every ant must be in the
+ * end room.
+ *
+ * The state is held in flat arrays, the room of each ant (4 bytes per ant) and the
+ * number of ants of each room, so each move is checked in constant time apart from
+ * a binary search among the tunnels of the room left. The replay stops at the first
+ * violation, which is kept with the step it happened in.
+ */
+class ScheduleVerifier {
+public:
+    /**
+     * @brief Prepares the replay on an anthill, every ant in the start room.
+     * @param graph Graph of the anthill, with the room capacities and tunnels.
+     * @param room_ids Identifier of each room, by index.
+     * @param start Index of the start room.
+     * @param end Index of the end room.
+     * @param ant_count Number of ants.
+     */
+    ScheduleVerifier(const Graph& graph, const std::vector<std::string>& room_ids, int start, int end,
+                     long long ant_count);
+
+    /**
+     * @brief Starts a step.
+     * @param step Number of the step, which must follow the previous one.
+     * @return false if a violation was found, now or before.
+     */
+    bool beginStep(long long step);
+
+    /**
+     * @brief Applies the move of one ant during the current step.
+     * @param ant Number of the ant, from 1 ("f1").
+     * @param from Index of the room left.
+     * @param to Index of the room entered.
+     * @return false if a violation was found, now or before.
+     */
+    bool move(long long ant, int from, int to);
+
+    /**
+     * @brief Checks that every ant reached the end room.
+     * @return false if a violation was found, now or before.
+     */
+    bool finish();
+
+    /**
+     * @brief Replays a text solution, then calls finish().
+     *
+     * The text is the one of displayBestSolution or displaySolutionSummary: lines
+     * before the first step are skipped, ant ranges "f<a>..f<b>" and repeated steps
+     * "+++ E<a> to E<b> (ants +<s> per step) +++" are expanded, and the closing
+     * "All ants have reached the dormitory!" is ignored.
+     *
+     * @param begin Pointer to the first character of the text.
+     * @param end Pointer just past the last character of the text.
+     * @return false if a violation was found.
+     */
+    bool verifyText(const char* begin, const char* end);
+
+    /**
+     * @brief Replays a binary solution, then calls finish().
+     *
+     * The rooms of the solution are matched to those of the anthill by identifier.
+     *
+     * @param reader Reader of the binary solution.
+     * @return false if a violation was found.
+     */
+    bool verifyBinary(const BinaryScheduleReader& reader);
+
+    /**
+     * @brief Tells whether no violation was found so far.
+     * @return true if every move replayed respects the rules.
+     */
+    bool isValid() const;
+
+    /**
+     * @brief Gets the first violation found.
+     * @return Description of the violation, with its step or line, empty if none.
+     */
+    const std::string& getViolation() const;
+
+    /**
+     * @brief Gets the number of steps of the solution replayed.
+     * @return Number of the last step holding a move.
+     */
+    long long getStepCount() const;
+
+    /**
+     * @brief Gets the number of single-ant moves replayed.
+     * @return The move count.
+     */
+    long long getMoveCount() const;
+
+private:
+    /** @brief Records the first violation and stops the replay */
+    bool fail(const std::string& reason);
+
+    /** @brief Records the first violation, found during the current step */
+    bool failStep(const std::string& reason);
+
+    /** @brief Tells whether a tunnel leads from a room to another */
+    bool hasTunnel(int from, int to) const;
+
+    /** @brief Ends the current step, allowing its ants to move again */
+    void endStep();
+
+    /** @brief Room of an ant, with this bit set once the ant moved during the step */
+    static const uint32_t MOVED = 0x80000000u;
+
+    std::vector<std::string> room_ids;           ///< Identifier of each room.
+    std::unordered_map<std::string, int> room_index;  ///< Index of each room, by identifier.
+    std::vector<int> offsets;                    ///< First tunnel of each room, plus the tunnel count.
+    std::vector<int> neighbors;                  ///< Room each tunnel leads to, sorted for each room.
+    std::vector<long long> capacity;             ///< Maximum number of ants of each room.
+    std::vector<long long> occupancy;            ///< Number of ants in each room.
+    std::vector<uint32_t> ant_rooms;             ///< Room of each ant, with the MOVED bit.
+    std::vector<long long> moved_ants;           ///< Ants that moved during the current step.
+    int start;                                   ///< Index of the start room.
+    int end;                                     ///< Index of the end room.
+    long long ant_count;                         ///< Number of ants.
+    long long step;                              ///< Current step, 0 before the first one.
+    long long last_step;                         ///< Last step holding a move.
+    long long move_count;                        ///< Number of moves replayed.
+    std::string violation;                       ///< First violation found, empty if none.
+};
+
+#endif //SCHEDULEVERIFIER_H
@@ -0,0 +1,118 @@
+/**
+ * @file ScheduleWriter.h
+ * @brief Header file defining the buffered output of the moves of a solution
+ */
+
+#ifndef SCHEDULEWRITER_H
+#define SCHEDULEWRITER_H
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * @class ScheduleWriter
+ * @brief Writes the steps and moves of a solution through a large reusable buffer.
+ *
+ * Lines are formatted directly into the buffer, numbers without going through a
+ * stream, and the buffer is written out in a single call whenever it is full, so a
+ * solution moving millions of ants is not flushed once per line. The text is the
+ * same as the one displayed with std::cout:
+ * - "\n+++ E<step> +++\n" before the moves of each step,
+ * - "<ant> - <from> - <to>\n" for each move.
+ *
+ * A compressed solution (see ScheduleStream) is written with ranges instead:
+ * - "\n+++ E<first> to E<last> (ants +<shift> per step) +++\n" before steps repeating
+ *   the same moves,
+ * - "f<first>..f<last> - <from> - <to>\n" for ants with consecutive numbers.
+ *
+ * The writer targets the standard output or a file. Text already sent to std::cout
+ * is flushed first, so the two outputs are never mixed up.
+ */
+class ScheduleWriter {
+public:
+    /** @brief Size of the buffer, in bytes */
+    static const size_t BUFFER_SIZE;
+
+    /**
+     * @brief Prepares a writer on the standard output.
+     */
+    ScheduleWriter();
+
+    /**
+     * @brief Prepares a writer on a file, replacing its content.
+     * @param filename Path of the file to write.
+     * @throws std::runtime_error if the file cannot be opened.
+     */
+    explicit ScheduleWriter(const std::string& filename);
+
+    /**
+     * @brief Writes out the buffer and closes the file, if any.
+     */
+    ~ScheduleWriter();
+
+    ScheduleWriter(const ScheduleWriter&) = delete;
+    ScheduleWriter& operator=(const ScheduleWriter&) = delete;
+
+    /**
+     * @brief Writes the header of a step.
+     * @param step Number of the step, from 1.
+     */
+    void writeStep(long long step);
+
+    /**
+     * @brief Writes the move of an ant.
+     * @param ant Identifier of the ant.
+     * @param from Identifier of the room the ant leaves.
+     * @param to Identifier of the room the ant enters.
+     */
+    void writeMove(const std::string& ant, const std::string& from, const std::string& to);
+
+    /**
+     * @brief Writes the header of steps repeating the same moves.
+     * @param first Number of the first step.
+     * @param last Number of the last step.
+     * @param shift Added to the ant numbers from one step to the next.
+     */
+    void writeSteps(long long first, long long last, long long shift);
+
+    /**
+     * @brief Writes the move of ants with consecutive numbers, named "f<number>".
+     * @param first_ant Number of the first ant.
+     * @param ants Number of ants moving.
+     * @param from Identifier of the room the ants leave.
+     * @param to Identifier of the room the ants enter.
+     */
+    void writeMoves(long long first_ant, long long ants, const std::string& from, const std::string& to);
+
+    /**
+     * @brief Writes a line of text.
+     * @param text Line to write, without its line break.
+     */
+    void writeLine(const std::string& text);
+
+    /**
+     * @brief Writes out the content of the buffer.
+     * @throws std::runtime_error if the output fails.
+     */
+    void flush();
+
+private:
+    /**
+     * @brief Appends characters to the buffer, writing it out first if they do not fit.
+     */
+    void append(const char* text, size_t length);
+
+    /**
+     * @brief Appends a number in decimal.
+     */
+    void appendNumber(long long value);
+
+    std::FILE* file;              ///< Output written to.
+    bool owned;                   ///< Whether the file was opened by the writer.
+    std::vector<char> buffer;     ///< Characters not written out yet.
+    size_t used;                  ///< Number of characters in the buffer.
+};
+
+#endif //SCHEDULEWRITER_H
@@ -0,0 +1,77 @@
+/**
+ * @file Simulation.h
+ * @brief Header file defining the ant movement simulation, separated from the rooms of the anthill
+ */
+
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <climits>
+#include <cstddef>
+#include <vector>
+#include "Deadline.h"
+#include "Graph.h"
+#include "Path.h"
+
+/**
+ * @brief Number of ants in every room during a simulation.
+ *
+ * The state only holds flat arrays indexed by room, so copying it is cheap and
+ * several simulations can run at the same time on their own copies.
+ */
+struct SimulationState {
+    /** @brief Number of ants in each room */
+    std::vector<int> occupancy;
+
+    /** @brief Number of ants that entered each room during the step stored in arrival_step */
+    std::vector<int> arrived;
+
+    /** @brief Last step during which ants entered each room */
+    std::vector<int> arrival_step;
+
+    /** @brief Current step of the simulation */
+    int step;
+
+    /**
+     * @brief Builds the state where every ant waits in the start room.
+     * @param graph Graph of the anthill.
+     * @param start Index of the start room.
+     * @param ant_count Number of ants.
+     */
+    SimulationState(const Graph& graph, int start, int ant_count);
+};
+
+/**
+ * @brief Simulates ant movement through given paths to count required steps.
+ *
+ * At each step, every path is processed in order and, from its end to its start,
+ * moves as many ants as the next room can take. An ant moves at most once per step:
+ * the ants that entered a room during the current step are the last ones of its
+ * queue and cannot leave it before the next step. Only the state is modified.
+ *
+ * When quotas are given, at most quotas[p] ants leave the start room through path p.
+ *
+ * A simulation that cannot finish in fewer than limit steps stops there: the caller
+ * only needs to know that the paths do not beat a known step count.
+ *
+ * A simulation given a deadline stops without a result once it expires, the
+ * deadline being checked every 256 steps.
+ *
+ * @param graph Graph providing the room capacities
+ * @param paths Paths the ants follow
+ * @param path_count Number of paths used, taken from the beginning of paths
+ * @param end Index of the end room
+ * @param ant_count Number of ants to bring to the end room
+ * @param state Occupancy of the rooms, updated by the simulation
+ * @param quotas Number of ants sent through each path, or nullptr for no limit
+ * @param limit Step count at which the simulation stops
+ * @param deadline Deadline of the simulation, or nullptr for no time limit
+ * @return Number of steps required to move all ants to the end room, limit if
+ *         they need at least that many, or -1 if the deadline expired first
+ */
+int simulate(const Graph& graph, const std::vector<Path>& paths, size_t path_count,
+             int end, int ant_count, SimulationState& state,
+             const std::vector<int>* quotas = nullptr, int limit = INT_MAX,
+             const Deadline* deadline = nullptr);
+
+#endif //SIMULATION_H
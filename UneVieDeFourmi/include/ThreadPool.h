@@ -0,0 +1,111 @@
+/**
+ * @file ThreadPool.h
+ * @brief Header file defining a work-stealing pool of worker threads
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Runs tasks on a fixed set of worker threads with work stealing.
+ *
+ * Every worker owns a deque of tasks. A task submitted from a worker goes to the
+ * back of that worker's deque and the worker takes its own tasks from the back
+ * (most recent, deepest work first), while idle workers steal from the front of
+ * the other deques (oldest, largest work first). Tasks submitted from outside the
+ * pool are spread over the deques.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Starts the worker threads.
+     * @param thread_count Number of workers (at least one; defaults to the hardware concurrency).
+     */
+    explicit ThreadPool(unsigned thread_count = std::thread::hardware_concurrency());
+
+    /**
+     * @brief Stops the workers once they are idle and joins them.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Queues a task.
+     * @param task Function to run on a worker. It may submit other tasks.
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * @brief Blocks until every submitted task has finished.
+     * @throws The first exception thrown by a task since the last wait, if any.
+     */
+    void wait();
+
+    /**
+     * @brief Gets the number of worker threads.
+     * @return The worker count.
+     */
+    unsigned getThreadCount() const;
+
+    /**
+     * @brief Checks whether a worker is waiting while no task is queued.
+     *
+     * Long tasks can poll this to split off part of their work for idle workers.
+     *
+     * @return True if submitting a task now would keep an idle worker busy.
+     */
+    bool isStarving() const;
+
+    /**
+     * @brief Gets the index of the worker running the calling code.
+     * @return Index between 0 and getThreadCount() - 1, or -1 outside the pool.
+     */
+    static int getWorkerIndex();
+
+private:
+    /**
+     * @brief Deque of tasks owned by one worker.
+     */
+    struct Queue {
+        std::mutex mutex;                          ///< Protects the tasks.
+        std::deque<std::function<void()>> tasks;   ///< Tasks waiting to run.
+    };
+
+    /**
+     * @brief Main loop of a worker thread.
+     */
+    void work(unsigned index);
+
+    /**
+     * @brief Takes a task from the worker's own deque, or steals one from another deque.
+     * @return True if a task was found.
+     */
+    bool takeTask(unsigned index, std::function<void()>& task);
+
+    std::vector<std::unique_ptr<Queue>> queues;    ///< One deque per worker.
+    std::vector<std::thread> threads;              ///< Worker threads.
+    std::mutex mutex;                              ///< Protects sleeping and completion waits.
+    std::condition_variable wake;                  ///< Signals queued tasks or shutdown to workers.
+    std::condition_variable done;                  ///< Signals that no task is pending.
+    std::atomic<int> queued;                       ///< Tasks waiting in the deques.
+    std::atomic<int> pending;                      ///< Tasks submitted and not finished.
+    std::atomic<int> idle;                         ///< Workers waiting for a task.
+    std::atomic<unsigned> next_queue;              ///< Deque receiving the next outside task.
+    std::exception_ptr failure;                    ///< First exception thrown by a task.
+    bool stopping;                                 ///< Whether the workers must exit.
+};
+
+#endif //THREADPOOL_H
@@ -0,0 +1,132 @@
+/**
+ * @file TimeExpandedScheduler.h
+ * @brief Header file defining the exact scheduler based on a maximum flow over a time-expanded network
+ */
+
+#ifndef TIMEEXPANDEDSCHEDULER_H
+#define TIMEEXPANDEDSCHEDULER_H
+
+#include <vector>
+#include "Deadline.h"
+#include "Graph.h"
+
+/**
+ * @brief Ants crossing one tunnel during a step of a schedule.
+ */
+struct ScheduledMove {
+    int from;   ///< Index of the room the ants leave.
+    int to;     ///< Index of the room the ants enter.
+    int ants;   ///< Number of ants crossing the tunnel.
+};
+
+/**
+ * @class TimeExpandedScheduler
+ * @brief Finds a schedule bringing every ant to the end room in the minimum number of steps.
+ *
+ * For a horizon of T steps, the anthill is copied once per step: node (room, t) is
+ * the room at the end of step t, split into an entry and an exit node joined by an
+ * arc of the room's capacity. Ants either wait (room, t) -> (room, t + 1) or cross a
+ * tunnel (room, t) -> (other, t + 1). The ants fit in T steps exactly when the maximum
+ * flow from (start, 0) to (end, T) carries all of them, and the smallest such T is
+ * found by binary search.
+ *
+ * The network grows with the number of steps, so horizons whose network would exceed
+ * an arc limit are not solved. The limit, DEFAULT_MAXIMUM_ARCS unless setMaximumArcs()
+ * changes it, bounds the memory of the search: about 60 bytes per arc.
+ *
+ * A search given a deadline stops once it expires, between two horizons or between
+ * two phases of a maximum flow, and keeps the shortest horizon proven to fit so far,
+ * which may not be the minimum.
+ */
+class TimeExpandedScheduler {
+public:
+    /** @brief Maximum number of arcs of a time-expanded network, unless changed (about 60 MB) */
+    static const long long DEFAULT_MAXIMUM_ARCS;
+
+    /** @brief Largest arc limit, the flow network numbering its edges with ints */
+    static const long long LARGEST_MAXIMUM_ARCS;
+
+    /**
+     * @brief Prepares a scheduler on a graph.
+     * @param graph Graph of the anthill, with the room capacities.
+     * @param source Index of the room every ant starts from.
+     * @param sink Index of the room every ant must reach.
+     * @param ant_count Number of ants.
+     */
+    TimeExpandedScheduler(const Graph& graph, int source, int sink, int ant_count);
+
+    /**
+     * @brief Finds the minimum number of steps and a schedule achieving it.
+     *
+     * @param upper Number of steps of a known schedule, the largest horizon tried.
+     * @param schedule Receives the moves of each step, in an order that never
+     *        brings an ant into a full room.
+     * @param lower Number of steps no schedule can beat (see LowerBound), the smallest
+     *        horizon tried; the length of the shortest path is used if it is larger.
+     * @return The minimum number of steps (the fewest found when interrupted), or -1
+     *         if no horizon below upper was found to fit or the network of the upper
+     *         horizon would be too large.
+     */
+    int solve(int upper, std::vector<std::vector<ScheduledMove>>& schedule, int lower = 0);
+
+    /**
+     * @brief Changes the largest time-expanded network searched.
+     * @param arcs Maximum number of arcs, between 1 and LARGEST_MAXIMUM_ARCS.
+     * @throws std::invalid_argument if the limit is out of range.
+     */
+    void setMaximumArcs(long long arcs);
+
+    /**
+     * @brief Stops the search when a deadline expires.
+     * @param deadline Deadline checked between two horizons and between the phases of their
+     *        maximum flows, which must outlive the search (none if null).
+     */
+    void setDeadline(const Deadline* deadline);
+
+    /**
+     * @brief Checks if the last search was stopped by its deadline.
+     * @return true if the number of steps found may not be the minimum.
+     */
+    bool wasInterrupted() const;
+
+private:
+    /**
+     * @brief Checks if every ant can reach the end room within a number of steps.
+     * @param steps Horizon of the time-expanded network.
+     * @param schedule Receives the moves of each step if not null and the ants fit.
+     * @return true if the maximum flow carries every ant, false if it does not or if
+     *         the deadline stopped it (interrupted is then set).
+     */
+    bool fits(int steps, std::vector<std::vector<ScheduledMove>>* schedule);
+
+    /**
+     * @brief Orders the moves of one step so that no room ever holds too many ants.
+     *
+     * Moves are carried out as soon as their destination has room. Moves going round a
+     * cycle of full rooms exchange ants that are all alike: they are cancelled.
+     *
+     * @param moves Moves of the step, in any order.
+     * @param occupancy Ants in each room, updated with the moves.
+     * @return The moves of the step in the order they can be carried out.
+     */
+    std::vector<ScheduledMove> orderMoves(std::vector<ScheduledMove> moves, std::vector<long long>& occupancy) const;
+
+    /**
+     * @brief Gets the number of steps to go from one room to every other one.
+     * @param origin Index of the room the search starts from.
+     * @return Distance of each room in tunnels, -1 if it cannot be reached.
+     */
+    std::vector<int> distancesFrom(int origin) const;
+
+    const Graph& graph;                 ///< Graph of the anthill.
+    int source;                         ///< Index of the start room.
+    int sink;                           ///< Index of the end room.
+    int ant_count;                      ///< Number of ants.
+    std::vector<int> from_source;       ///< Distance of each room from the start room.
+    std::vector<int> to_sink;           ///< Distance of each room to the end room.
+    long long maximum_arcs;             ///< Largest network searched, in arcs.
+    const Deadline* deadline;           ///< Deadline of the search, null if unlimited.
+    bool interrupted;                   ///< Whether the deadline stopped the last search.
+};
+
+#endif //TIMEEXPANDEDSCHEDULER_H
@@ -1,31 +1,136 @@
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
 #include <exception>
 #include "include/Anthill.h"
 
-int main() {
+namespace {
+
+void printUsage(const char* program) {
+    std::cerr << "Usage : " << program << " [<anthill file>] [--maxflow | --lazy] [--greedy]"
+              << " [--time-limit <seconds>] [--schedule-arcs <number>] [--summary | --binary <solution file>]"
+              << " [--output <text file>] [--cache]" << std::endl;
+    std::cerr << "  --schedule-arcs  largest network of the optimal schedule search, in arcs of about 60 bytes"
+              << " (default " << TimeExpandedScheduler::DEFAULT_MAXIMUM_ARCS << ")" << std::endl;
+}
+
+bool readValue(int argc, char* argv[], int& i, std::string& value) {
+    // The value follows its option and is never another option
+    if (i + 1 >= argc || std::strncmp(argv[i + 1], "--", 2) == 0) return false;
+    value = argv[++i];
+    return true;
+}
+
+bool readSeconds(const std::string& text, double& seconds) {
+    // The whole text must be a finite number of seconds, not negative
+    char* end = nullptr;
+    errno = 0;
+    seconds = std::strtod(text.c_str(), &end);
+    return !text.empty() && *end == '\0' && errno == 0 && std::isfinite(seconds) && seconds >= 0;
+}
+
+bool readNumber(const std::string& text, long long& number) {
+    // The whole text must be a number that fits
+    char* end = nullptr;
+    errno = 0;
+    number = std::strtoll(text.c_str(), &end, 10);
+    return !text.empty() && *end == '\0' && errno == 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
     try {
-        const std::string filename = "C:/Users/gravy/Desktop/PROJETS/FOURMIS/uneviedefourmi/UneVieDeFourmi/fourmilieres/fourmiliere_cinq.txt";
-
-        // Create an anthill
-        Anthill anthill0(filename);
-        std::cout << "Anthill created" << std::endl;
-        anthill0.loadRooms(filename);
-        std::cout << "Rooms loaded" << std::endl;
-        anthill0.loadConnections(filename);
-        std::cout << "Connections loaded" << std::endl;
+        std::string filename = "C:/Users/gravy/Desktop/PROJETS/FOURMIS/uneviedefourmi/UneVieDeFourmi/fourmilieres/fourmiliere_cinq.txt";
+        bool useMaxFlow = false;
+        bool useLazyPaths = false;
+        bool useGreedySchedule = false;
+        double timeLimit = -1;
+        long long scheduleArcs = TimeExpandedScheduler::DEFAULT_MAXIMUM_ARCS;
+        std::string solutionFile;
+        bool useSummary = false;
+        std::string binaryFile;
+        bool useCache = false;
+
+        // Read the anthill file and the solver options from the command line, an unknown
+        // option or a missing value stopping with the usage
+        bool hasFilename = false;
+        for (int i = 1; i < argc; i++) {
+            const std::string arg = argv[i];
+            std::string value;
+            bool known = true;
+            if (arg == "--maxflow") {
+                useMaxFlow = true;
+            } else if (arg == "--lazy") {
+                useLazyPaths = true;
+            } else if (arg == "--greedy") {
+                useGreedySchedule = true;
+            } else if (arg == "--time-limit") {
+                known = readValue(argc, argv, i, value) && readSeconds(value, timeLimit);
+            } else if (arg == "--schedule-arcs") {
+                known = readValue(argc, argv, i, value) && readNumber(value, scheduleArcs) && scheduleArcs >= 1 &&
+                        scheduleArcs <= TimeExpandedScheduler::LARGEST_MAXIMUM_ARCS;
+            } else if (arg == "--summary") {
+                useSummary = true;
+            } else if (arg == "--binary") {
+                known = readValue(argc, argv, i, binaryFile);
+            } else if (arg == "--cache") {
+                useCache = true;
+            } else if (arg == "--output") {
+                known = readValue(argc, argv, i, solutionFile);
+            } else if (arg[0] != '-' && !hasFilename) {
+                filename = arg;
+                hasFilename = true;
+            } else {
+                known = false;
+            }
+            if (!known) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+
+        // Create an anthill, its rooms and tunnels cached next to the file if asked
+        Anthill anthill0(filename, useCache ? filename + ".cache" : "");
+        std::cout << (anthill0.isCached() ? "Anthill created from the graph cache" : "Anthill created") << std::endl;
         anthill0.displayAnthill();
         std::cout << "Anthill structure displayed" << std::endl;
 
-        // Research and analyze paths
-        anthill0.searchAllPaths();
-        anthill0.sortAllPaths();
-        anthill0.displayPaths(anthill0.getAllPaths(), "All paths");
+        // The searches stop at the time limit (in seconds), keeping the best solution found
+        if (timeLimit >= 0) {
+            anthill0.setTimeLimit(timeLimit);
+        }
+        anthill0.setScheduleArcLimit(scheduleArcs);
+
+        // Research and analyze paths (the lazy mode generates them during optimisation)
+        if (!useLazyPaths) {
+            if (useMaxFlow) {
+                anthill0.searchMaxFlowPaths();
+            } else {
+                anthill0.searchAllPaths();
+            }
+            anthill0.sortAllPaths();
+            anthill0.displayPaths(anthill0.getAllPaths(), "All paths");
+        }
 
         // Optimisation et results
         anthill0.findOptimalPaths();
         anthill0.displayPaths(anthill0.getOptimalPaths(), "Optimal paths");
-        anthill0.displayBestSolution();
+        if (!useGreedySchedule) {
+            anthill0.findOptimalSchedule();
+        }
+        anthill0.displaySolveResult();
+        anthill0.setSolutionFile(solutionFile);
+        if (!binaryFile.empty()) {
+            anthill0.writeBinarySolution(binaryFile);
+        } else if (useSummary) {
+            anthill0.displaySolutionSummary();
+        } else {
+            anthill0.displayBestSolution();
+        }
 
     } catch (const std::exception& e) {
         std::cerr << "Error : " << e.what() << std::endl;
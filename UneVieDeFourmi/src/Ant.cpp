@@ -4,7 +4,7 @@
 #include "../include/Anthill.h"
 
 Ant::Ant(std::string id, Room* current, Room* previous)
-    : id_ant(id), current_room(current), previous_room(previous), canMove(true) {}
+    : id_ant(id), current_room(current), previous_room(previous) {}
 
 
 
@@ -12,8 +12,8 @@ Ant::~Ant() {}
 
 
 
-std::string Ant::getId() const {
-    // Return a copy of the ID string
+const std::string& Ant::getId() const {
+    // Return the ID string without copying it
     return id_ant;
 }
 
@@ -24,22 +24,6 @@ void Ant::moves(Room* new_room) {
     previous_room = current_room;
     // Set the new room as current
     current_room = new_room;
-    // Disable movement until the next turn
-    canMove = false;
-}
-
-
-
-bool Ant::getCanMove() const {
-    // Return the movement capability status of the ant
-    return canMove;
-}
-
-
-
-void Ant::toggleCanMove() {
-    // Toggle the movement capability between true and false
-    canMove = !canMove;
 }
 
 
@@ -1,169 +1,370 @@
 
 #include <iostream>
 #include <string>
-#include <fstream>
-#include <sstream>
 #include <vector>
 #include <algorithm>
+#include <cstring>
+#include <stdexcept>
 #include <thread>
+#include <climits>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include "../include/BinarySchedule.h"
+#include "../include/DisjointPathSelector.h"
+#include "../include/GraphCache.h"
+#include "../include/GraphReduction.h"
+#include "../include/KShortestPaths.h"
+#include "../include/LowerBound.h"
+#include "../include/Makespan.h"
+#include "../include/MappedFile.h"
+#include "../include/PathEnumerator.h"
 #include "../include/Room.h"
+#include "../include/RoomFlow.h"
+#include "../include/Simulation.h"
+#include "../include/TimeExpandedScheduler.h"
 #include "../include/Ant.h"
 #include "../include/Anthill.h"
 
 
 
-Anthill::Anthill(const std::string& filename) : room_count(0), ant_count(0) {
-    // Open the configuration file
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        throw std::runtime_error("Could not open file " + filename);
+namespace {
+
+/**
+ * @brief Word of a line of the anthill file, pointing into the mapped content.
+ */
+struct Token {
+    const char* text;   ///< First character of the word.
+    size_t length;      ///< Number of characters of the word.
+};
+
+bool isBlank(char c) {
+    // Spaces, tabs and carriage returns (Windows line endings) separate words
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+bool nextToken(const char*& cursor, const char* end, Token& token) {
+    // Skip the blanks before the word
+    while (cursor < end && isBlank(*cursor)) cursor++;
+    if (cursor == end) return false;
+
+    // The word ends at the next blank or at the end of the line
+    token.text = cursor;
+    while (cursor < end && !isBlank(*cursor)) cursor++;
+    token.length = cursor - token.text;
+    return true;
+}
+
+int parseNumber(const char* cursor, const char* end) {
+    // Skip leading blanks, then read an optionally signed decimal number
+    while (cursor < end && isBlank(*cursor)) cursor++;
+    bool negative = false;
+    if (cursor < end && (*cursor == '-' || *cursor == '+')) {
+        negative = *cursor == '-';
+        cursor++;
     }
-    std::string line;
+    if (cursor == end || *cursor < '0' || *cursor > '9') {
+        throw std::runtime_error("Invalid file format : expected a number");
+    }
+    long long value = 0;
+    while (cursor < end && *cursor >= '0' && *cursor <= '9') {
+        value = value * 10 + (*cursor - '0');
+        if (value > INT_MAX) {
+            throw std::runtime_error("Invalid file format : number out of range");
+        }
+        cursor++;
+    }
+    return static_cast<int>(negative ? -value : value);
+}
+
+bool startsWith(const char* begin, const char* end, const char* prefix) {
+    // Compare the beginning of the line with the prefix
+    for (; *prefix; prefix++, begin++) {
+        if (begin == end || *begin != *prefix) return false;
+    }
+    return true;
+}
+
+const char* parseCounts(const char* begin, const char* end, int& room_count, int& ant_count) {
+    const char* cursor = begin;
 
     // Read and parse the number of rooms (expected format: "r=X")
-    if (std::getline(file, line)) {
-        if (line.substr(0, 2) == "r=") {
-            room_count = std::stoi(line.substr(2));
+    if (cursor < end) {
+        const char* line_end = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+        if (!line_end) line_end = end;
+        if (startsWith(cursor, line_end, "r=")) {
+            room_count = parseNumber(cursor + 2, line_end);
         } else {
             throw std::runtime_error("Invalid file format : missing room count");
         }
+        cursor = line_end + 1;
     }
 
     // Read and parse the number of ants (expected format: "f=X")
-    if (std::getline(file, line)) {
-        if (line.substr(0, 2) == "f=") {
-            ant_count = std::stoi(line.substr(2));
+    if (cursor < end) {
+        const char* line_end = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+        if (!line_end) line_end = end;
+        if (startsWith(cursor, line_end, "f=")) {
+            ant_count = parseNumber(cursor + 2, line_end);
         } else {
             throw std::runtime_error("Invalid file format : missing ant count");
         }
+        cursor = line_end + 1;
     }
 
-    // Create the start room "Sv" with capacity equal to the number of ants
-    rooms.push_back(new Room("Sv", ant_count));
+    // Position of the first room or connection line
+    return cursor;
+}
 
-    // Create ants and add them to the start room
-    for (int i = 1; i <= ant_count; i++) {
-        rooms[0]->addAnt(new Ant("f" + std::to_string(i),rooms[0]));
+} // namespace
+
+
+
+Anthill::Anthill(const std::string& filename, const std::string& cache_file)
+    : room_count(0), ant_count(0), start_index(0), end_index(0) {
+    // Map the configuration file and parse it in a single pass
+    MappedFile file(filename);
+    if (cache_file.empty()) {
+        load(file.begin(), file.end());
+        return;
     }
 
-    file.close();
+    // Reuse the cache written from the same rooms and tunnels, or parse and write it
+    SourceDigest digest = GraphCache::hashAnthill(file.begin(), file.end());
+    if (!loadCache(cache_file, digest, file.begin(), file.end())) {
+        load(file.begin(), file.end());
+        writeCache(cache_file, digest);
+    }
 }
 
 
 
-Anthill::~Anthill() {
-    // Delete all dynamically allocated Room objects
-    for (Room* room : rooms) {
-        delete room;
+bool Anthill::loadCache(const std::string& cache_file, const SourceDigest& digest, const char* begin,
+                        const char* end) {
+    // A missing, invalid or stale cache is replaced by a parse of the file
+    try {
+        cache.reset(new GraphCache(cache_file));
+    } catch (const std::exception&) {
+        return false;
     }
-    // Clear the vector of pointers
-    rooms.clear();
+    if (!(cache->getDigest() == digest)) {
+        cache.reset();
+        return false;
+    }
+
+    // Only the number of ants is read from the file, the rest comes from the cache
+    int file_room_count = 0;
+    parseCounts(begin, end, file_room_count, ant_count);
+    room_count = cache->getRoomCount();
+    start_index = cache->getStart();
+    end_index = cache->getEnd();
+    graph.view(cache->getNodeCount(), cache->getCapacities(), cache->getOffsets(), cache->getNeighbors());
+
+    // The start and end rooms hold every ant, which wait in the start room
+    graph.setCapacity(start_index, ant_count);
+    graph.setCapacity(end_index, ant_count);
+    graph.addOccupancy(start_index, ant_count);
+
+    // Rooms are created when first used, their IDs read from the cache and interned by
+    // the first lookup
+    rooms.assign(cache->getNodeCount(), nullptr);
+    cached = true;
+    return true;
 }
 
 
 
-void Anthill::loadRooms(const std::string &filename) {
-    // Open the configuration file
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        throw std::runtime_error("Could not open file" + filename);
+void Anthill::writeCache(const std::string& cache_file, const SourceDigest& digest) const {
+    // The anthill is loaded whether or not its cache could be written
+    try {
+        GraphCache::write(cache_file, digest, room_count, graph, getRoomIds(), start_index, end_index);
+    } catch (const std::exception& e) {
+        std::cerr << "Warning : " << e.what() << std::endl;
     }
+}
 
-    std::string line;
 
-    // Process each line of the file
-    while (std::getline(file, line)) {
-        if (line.empty()) {
-            continue;
-        }
 
-        // Ignore lines with '-' or '=' which are connection lines or metadata
-        if (line.find("-") == std::string::npos && line.find("=") == std::string::npos) {
-            std::string identifier;
-            int capacity;
+bool Anthill::isCached() const {
+    // Whether the rooms and tunnels came from the cache
+    return cached;
+}
 
-            // Extract room identifier from a line
-            std::istringstream linestream(line);
-            linestream >> identifier;
 
-            // Check for optional capacity specification {X}
-            size_t open = line.find('{');
-            size_t close = line.find('}');
-            if (open != std::string::npos && close != std::string::npos && close > open) {
-                // Extract and parse capacity value
-                std::string value = line.substr(open + 1, close - open - 1);
-                capacity = std::stoi(value);
-            } else {
-                capacity = 1; // default capacity
-            }
 
-            // Create a new room if the identifier is valid
-            if (!identifier.empty()) {
-                rooms.push_back(new Room(identifier, capacity));
-            }
-        }
+const Graph& Anthill::getGraph() const {
+    // Return the capacities and tunnels of the rooms
+    return graph;
+}
+
+
+
+std::vector<std::string> Anthill::getRoomIds() const {
+    // Copy the identifier of each room, by index
+    std::vector<std::string> ids;
+    ids.reserve(rooms.size());
+    for (size_t index = 0; index < rooms.size(); index++) {
+        ids.push_back(getRoomId(static_cast<int>(index)));
     }
-    file.close();
+    return ids;
+}
 
-    // Add the destination room "Sd" with capacity equal to ant_count
-    rooms.push_back(new Room("Sd", ant_count));
+
+
+int Anthill::getStartIndex() const {
+    // Return the index of the start room
+    return start_index;
 }
 
 
 
-void Anthill::loadConnections(const std::string &filename) const {
-    // Open the configuration file
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        throw std::runtime_error("Could not open file" + filename);
-    }
+int Anthill::getEndIndex() const {
+    // Return the index of the end room
+    return end_index;
+}
+
+
+
+int Anthill::getAntCount() const {
+    // Return the number of ants
+    return ant_count;
+}
 
-    std::string line;
 
-    // Process each line of the file
-    while (std::getline(file, line)) {
-        if (line.empty()) {
-            continue;
-        }
-        // Look for lines containing the connection symbol '-'
-        if (line.find("-") != std::string::npos) {
-            std::istringstream linestream(line);
-            std::string from, dash, to;
-            linestream >> from >> dash >> to;
 
-            // Validate connection format (RoomID1 - RoomID2)
-            if (!from.empty() && !to.empty() && dash == "-") {
-                // Find the rooms to connect
-                Room* parent = findRoomById(from);
-                Room* child = findRoomById(to);
+void Anthill::load(const char* begin, const char* end) {
+    const char* cursor = begin;
+    const char* line_end = begin;
+    std::vector<std::pair<Token, Token>> connections;
 
-                // Create a bidirectional connection between rooms
-                if (parent && child) {
-                    parent->addChildNode(child);
-                    child->addChildNode(parent); // Make connection bidirectional
+    // Advance to the next line, returning false at the end of the content
+    auto nextLine = [&]() {
+        if (cursor >= end) return false;
+        line_end = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+        if (!line_end) line_end = end;
+        return true;
+    };
+
+    // Read the numbers of rooms and ants of the first two lines
+    cursor = parseCounts(begin, end, room_count, ant_count);
+
+    // Create the start room "Sv" with capacity equal to the number of ants
+    start_index = addRoom("Sv", ant_count);
+
+    // Every ant waits in the start room, only counted until it leaves it
+    graph.addOccupancy(start_index, ant_count);
+
+    // Process each remaining line: rooms are created now, connections once all rooms exist
+    while (nextLine()) {
+        const char* dash = static_cast<const char*>(std::memchr(cursor, '-', line_end - cursor));
+
+        if (dash) {
+            // Connection line (RoomID1 - RoomID2)
+            Token from, separator, to;
+            const char* word = cursor;
+            if (nextToken(word, line_end, from) && nextToken(word, line_end, separator) &&
+                nextToken(word, line_end, to) && separator.length == 1 && *separator.text == '-') {
+                connections.push_back(std::make_pair(from, to));
+            }
+        } else if (!std::memchr(cursor, '=', line_end - cursor)) {
+            // Room line, with an optional capacity specification {X}
+            Token identifier;
+            const char* word = cursor;
+            if (nextToken(word, line_end, identifier)) {
+                int capacity = 1; // default capacity
+                const char* open = static_cast<const char*>(std::memchr(cursor, '{', line_end - cursor));
+                const char* close = static_cast<const char*>(std::memchr(cursor, '}', line_end - cursor));
+                if (open && close && close > open) {
+                    capacity = parseNumber(open + 1, close);
                 }
+                addRoom(std::string(identifier.text, identifier.length), capacity);
             }
         }
+        cursor = line_end + 1;
+    }
 
+    // Add the destination room "Sd" with capacity equal to ant_count
+    end_index = addRoom("Sd", ant_count);
+
+    // Create a bidirectional connection between the rooms of each connection line,
+    // reusing the same key buffers for every hash table lookup
+    std::string from_id, to_id;
+    for (const auto& connection : connections) {
+        from_id.assign(connection.first.text, connection.first.length);
+        to_id.assign(connection.second.text, connection.second.length);
+        auto from = room_index.find(from_id);
+        auto to = room_index.find(to_id);
+        if (from != room_index.end() && to != room_index.end()) {
+            graph.addEdge(from->second, to->second);
+            graph.addEdge(to->second, from->second); // Make connection bidirectional
+        }
     }
-    file.close();
+
+    // Lay the tunnels out contiguously
+    graph.build();
 }
 
 
 
-Room* Anthill::findRoomById(const std::string& id) const {
-    // Search through all rooms in the anthill
+Anthill::~Anthill() {
+    // Delete all dynamically allocated Room objects
     for (Room* room : rooms) {
-        // Compare room ID with searched ID
-        if (room->getId() == id) {
-            return room; // Return room if found
+        delete room;
+    }
+    // Clear the vector of pointers
+    rooms.clear();
+}
+
+
+
+int Anthill::addRoom(const std::string& id, int capacity) {
+    // The new room takes the next node of the graph
+    int index = graph.addNode(capacity);
+    rooms.push_back(new Room(id, graph, index));
+    // Intern the ID, keeping the first room declared when an ID is repeated
+    room_index.emplace(id, index);
+    return index;
+}
+
+
+
+Room* Anthill::findRoomById(const std::string& id) {
+    // Intern the IDs of rooms loaded from the cache, keeping the first room of a repeated ID
+    if (room_index.empty()) {
+        room_index.reserve(rooms.size());
+        for (size_t index = 0; index < rooms.size(); index++) {
+            room_index.emplace(getRoomId(static_cast<int>(index)), static_cast<int>(index));
         }
     }
+
+    // Look the ID up in the interned room index
+    auto found = room_index.find(id);
+    if (found != room_index.end()) {
+        return getRoom(found->second); // Return room if found
+    }
     return nullptr; // Return null if room not found
 }
 
 
 
+Room* Anthill::getRoom(int index) {
+    // Rooms loaded from the cache are created the first time they are used
+    if (!rooms[index]) {
+        rooms[index] = new Room(cache->getRoomId(index), graph, index);
+    }
+    return rooms[index];
+}
+
+
+
+std::string Anthill::getRoomId(int index) const {
+    // The room holds its ID once created, the cache before
+    return rooms[index] ? rooms[index]->getId() : cache->getRoomId(index);
+}
+
+
+
 void Anthill::displayAnthill() const {
     // Check if there are any rooms in the anthill
     if (rooms.empty()) {
@@ -171,25 +372,100 @@ void Anthill::displayAnthill() const {
         return;
     }
 
-    // Create a set to track visited rooms during traversal and avoid infinite loops
-    std::set<const Room*> visited;
+    // Track visited rooms during traversal to avoid infinite loops
+    std::vector<bool> visited(rooms.size(), false);
     std::cout << "=== Map of the anthill ===" << std::endl;
-    // Start a recursive display from the first room (index 0)
-    rooms[0]->display(0, visited);
+
+    // Depth-first display from the first room (index 0), with an explicit stack
+    // of (room, next arc to follow) so deep anthills cannot overflow the call stack
+    std::vector<std::pair<int, int>> stack;
+    int room = 0;
+    while (true) {
+        if (!visited[room]) {
+            visited[room] = true;
+            int depth = 2 * static_cast<int>(stack.size());
+
+            // Print indentation on the depth level
+            for (int i = 0; i < depth; i++) std::cout << " ";
+
+            // Display room information: ID and ant occupancy
+            std::cout << "-Room \"" << getRoomId(room) << "\""
+            << " | Ants: " << graph.getOccupancy(room) << "/" << graph.getCapacity(room);
+
+            // If a room has connections, display them
+            if (graph.getDegree(room) > 0) {
+                std::cout << " | Children: ";
+                for (int arc = graph.getArcBegin(room); arc < graph.getArcEnd(room); arc++) {
+                    std::cout << getRoomId(graph.getArcTarget(arc));
+                    // Add comma separator between children, except for the last one
+                    if (arc != graph.getArcEnd(room) - 1) std::cout << ", ";
+                }
+            }
+            std::cout << std::endl;
+
+            // Continue with the connected rooms with increased indentation
+            stack.push_back(std::make_pair(room, graph.getArcBegin(room)));
+        }
+
+        // Go back up until a room still has a connection to follow
+        while (!stack.empty() && stack.back().second == graph.getArcEnd(stack.back().first)) {
+            stack.pop_back();
+        }
+        if (stack.empty()) break;
+        room = graph.getArcTarget(stack.back().second++);
+    }
 }
 
 
 
 void Anthill::antMovementDisplay(Room* origin_room, Room* direction_room) {
-    if (!origin_room || !direction_room) return;
+    // A single ant is a batch of one
+    moveAnts(origin_room, direction_room, 1);
+}
 
-    Ant* ant = origin_room->getFirstAnt();
-    if (ant && ant->getCanMove() == true) {
-        direction_room->addAnt(ant);
+
+
+int Anthill::moveAnts(Room* origin_room, Room* direction_room, int count) {
+    if (!origin_room || !direction_room || count <= 0) return 0;
+    bool from_start = origin_room->getIndex() == start_index;
+    bool to_end = direction_room->getIndex() == end_index;
+    moving_ants.clear();
+
+    if (from_start) {
+        // Ants of the start room are counted: the ones leaving are created, numbered
+        // after the ants that already left (the room is a FIFO queue)
+        int moving = std::min(count, origin_room->getAntsInside());
+        if (!to_end) {
+            moving = std::min(moving, direction_room->getCapacity() - direction_room->getAntsInside());
+        }
+        for (int i = 0; i < moving; i++) {
+            moving_ants.push_back(new Ant("f" + std::to_string(++released_ants), origin_room));
+        }
+        origin_room->addAntCount(-static_cast<int>(moving_ants.size()));
+        if (!to_end) direction_room->receiveAnts(moving_ants, move_epoch);
+    } else if (to_end) {
+        origin_room->takeAnts(count, move_epoch, moving_ants);
+    } else {
+        origin_room->transferAnts(*direction_room, count, move_epoch, &moving_ants);
+    }
+
+    for (Ant* ant : moving_ants) {
         ant->moves(direction_room);
-        ant->displayMovement();
-        origin_room->removeAnt();
+        if (writer) {
+            writer->writeMove(ant->getId(), origin_room->getId(), direction_room->getId());
+        } else {
+            ant->displayMovement();
+        }
     }
+
+    // Ants reaching the end room are only counted as well
+    if (to_end) {
+        direction_room->addAntCount(static_cast<int>(moving_ants.size()));
+        for (Ant* ant : moving_ants) {
+            delete ant;
+        }
+    }
+    return static_cast<int>(moving_ants.size());
 }
 
 
@@ -202,46 +478,73 @@ void Anthill::displayBestSolution() {
     }
 
     // Get start and end rooms
-    Room* start = findRoomById("Sv");
-    Room* end = findRoomById("Sd");
-
-    if (!start || !end) {
-        throw std::runtime_error("Error: Unable to find start or end rooms");
-    }
+    Room* start = getRoom(start_index);
+    Room* end = getRoom(end_index);
 
     int step = 1;
     bool someAntMoved;
 
     // Reset simulation by moving all ants back to the start room
-    while (end->getAntsInside() > 0) {
-        movesAnt(end, start);
+    start->addAntCount(end->getAntsInside());
+    end->addAntCount(-end->getAntsInside());
+    released_ants = 0;
+
+    // Every step and move goes through a single buffered output
+    std::unique_ptr<ScheduleWriter> output(solution_file.empty() ? new ScheduleWriter()
+                                                                 : new ScheduleWriter(solution_file));
+    writer = output.get();
+
+    // Replay the optimal schedule when one was found
+    if (!schedule.empty()) {
+        for (const auto& moves : schedule) {
+            writer->writeStep(step);
+            move_epoch++;
+            for (const ScheduledMove& move : moves) {
+                moveAnts(getRoom(move.from), getRoom(move.to), move.ants);
+            }
+            step++;
+        }
+        writer->writeStep(step);
+        writer->writeLine("All ants have reached the dormitory!");
+        writer->flush();
+        writer = nullptr;
+        return;
     }
 
+    // Ants that may still leave the start room through each path
+    std::vector<int> remaining = pathQuotas;
+
     do {
         // Display the current step number
-        std::cout << "\n+++ E" << step << " +++" << std::endl;
+        writer->writeStep(step);
 
-        // Prepare for a new movement phase
-        resetAllAntsCanMove();
+        // Prepare for a new movement phase: every ant may move again
+        move_epoch++;
         someAntMoved = false;
 
         // Process each optimal path
-        for (const auto& path : optimalPaths) {
+        for (size_t p = 0; p < optimalPaths.size(); p++) {
+            const Path& path = optimalPaths[p];
+
             // Move ants from end to start of each path
             for (int i = path.path.size() - 2; i >= 0; i--) {
                 Room* previousRoom = const_cast<Room*>(path.path[i]);
                 Room* currentRoom = const_cast<Room*>(path.path[i + 1]);
 
                 // Calculate how many ants can move between these rooms
-                int antsInPrevious = previousRoom->getAntsInside();
-                int spaceInCurrent = currentRoom->getCapacity() - currentRoom->getAntsInside();
+                int previous = previousRoom->getIndex();
+                int current = currentRoom->getIndex();
+                int antsInPrevious = graph.getOccupancy(previous);
+                int spaceInCurrent = graph.getCapacity(current) - graph.getOccupancy(current);
                 int antsToMove = std::min(antsInPrevious, spaceInCurrent);
+                if (!remaining.empty() && i == 0) {
+                    antsToMove = std::min(antsToMove, remaining[p]);
+                    remaining[p] -= antsToMove;
+                }
 
-                // Move ants if possible
+                // Move ants if possible, all of them at once
                 if (antsToMove > 0) {
-                    for (int j = 0; j < antsToMove; j++) {
-                        antMovementDisplay(previousRoom, currentRoom);
-                    }
+                    moveAnts(previousRoom, currentRoom, antsToMove);
                     someAntMoved = true;
                 }
             }
@@ -249,111 +552,233 @@ void Anthill::displayBestSolution() {
         step++;
     } while (someAntMoved); // Continue until no more movements are possible
 
-    std::cout << "All ants have reached the dormitory!" << std::endl;
+    writer->writeLine("All ants have reached the dormitory!");
+    writer->flush();
+    writer = nullptr;
 }
 
 
 
-void Anthill::movesAnt(Room* origin_room, Room* direction_room) {
-    // Verify that both room pointers are valid
-    if (!origin_room || !direction_room) return;
-
-    // Get the first available ant from the origin room
-    Ant* ant = origin_room->getFirstAnt();
+void Anthill::displaySolutionSummary() {
+    // Check if we have any valid paths to use
+    if (optimalPaths.empty()) {
+        std::cout << "No valid paths found for ant movement" << std::endl;
+        return;
+    }
 
-    // Check if there is an ant and if it's allowed to move
-    if (ant && ant->getCanMove() == true) {
-        // Perform the actual movement
-        direction_room->addAnt(ant);   // Add ant to the new room
-        origin_room->removeAnt();      // Remove ant from the old room
-        ant->toggleCanMove();          // Mark ant as moved for this turn
+    // Produce the steps of the schedule, or of the paths, on demand
+    std::unique_ptr<ScheduleStream> stream(schedule.empty()
+        ? new ScheduleStream(graph, start_index, end_index, ant_count, optimalPaths,
+                             pathQuotas.empty() ? nullptr : &pathQuotas)
+        : new ScheduleStream(graph, start_index, end_index, ant_count, schedule));
+    std::unique_ptr<ScheduleWriter> output(solution_file.empty() ? new ScheduleWriter()
+                                                                 : new ScheduleWriter(solution_file));
+
+    // Write each run of steps repeating the same moves once
+    ScheduleRun run;
+    while (stream->nextRun(run)) {
+        if (run.repeat == 1) {
+            output->writeStep(run.first_step);
+        } else {
+            output->writeSteps(run.first_step, run.first_step + run.repeat - 1, run.shift);
+        }
+        for (const AntMove& move : run.moves) {
+            output->writeMoves(move.first_ant, move.ants, getRoom(move.from)->getId(), getRoom(move.to)->getId());
+        }
     }
+    output->writeStep(stream->getStep() + 1);
+    output->writeLine("All ants have reached the dormitory!");
+    output->flush();
 }
 
 
 
-void Anthill::resetAllAntsCanMove () {
-    // Iterate through all rooms in the anthill
-    for (Room* room : rooms) {
-        // For each ant in the current room
-        for (Ant* ant : room->getAnts()) {
-            if (ant->getCanMove() == false) {
-                ant->toggleCanMove(); // Set canMove to true
-            }
-        }
+void Anthill::writeBinarySolution(const std::string& filename) {
+    // Check if we have any valid paths to use
+    if (optimalPaths.empty()) {
+        std::cout << "No valid paths found for ant movement" << std::endl;
+        return;
+    }
+
+    // Write each step produced by the stream
+    std::unique_ptr<ScheduleStream> stream(schedule.empty()
+        ? new ScheduleStream(graph, start_index, end_index, ant_count, optimalPaths,
+                             pathQuotas.empty() ? nullptr : &pathQuotas)
+        : new ScheduleStream(graph, start_index, end_index, ant_count, schedule));
+    // The room table gives the identifiers of the room indices written
+    BinaryScheduleWriter output(filename, getRoomIds(), ant_count, start_index, end_index);
+    std::vector<AntMove> moves;
+    while (stream->next(moves)) {
+        output.writeStep(moves);
     }
+    output.finish();
+    std::cout << "Binary solution written : " << stream->getStep() << " steps" << std::endl;
+}
+
+
+
+void Anthill::setSolutionFile(const std::string& filename) {
+    // displayBestSolution writes to this file from now on
+    solution_file = filename;
 }
 
 
 
 int Anthill::simulateAntsMovement(Room* start, Room* end) {
-    int steps = 0;
-    bool someAntMoved;
+    // Simulate on a separate state where every ant waits in the start room
+    SimulationState state(graph, start->getIndex(), ant_count);
+    return simulate(graph, optimalPaths, optimalPaths.size(), end->getIndex(), ant_count, state,
+                    pathQuotas.empty() ? nullptr : &pathQuotas);
+}
 
-    // Reset simulation by moving all ants back to the start room
-    while (end->getAntsInside() > 0) {
-        this->movesAnt(end, start);
+
+
+void Anthill::searchAllPaths() {
+    // Check if there are any rooms in the anthill
+    if (rooms.empty()) {
+        std::cout << "No rooms found" << std::endl;
+        return;
     }
 
-    do {
-        someAntMoved = false;
-        this->resetAllAntsCanMove();
+    // The maximum flow is needed by a partial search and by the lower bound: compute it
+    // first, so that it counts against the time limit
+    getRoomFlow();
 
-        // Check if all ants have reached the end room
-        if (end->getAntsInside() ==  ant_count) {
-            break;
-        }
+    // Search the graph without dead ends, its corridors contracted into single nodes
+    ReducedGraph reduced(graph, start_index, end_index);
 
-        // Try moving ants along each optimal path
-        for (const auto& path : optimalPaths) {
-            // Move ants from back to front of each path
-            for (int i = path.path.size() - 2; i >= 0; i--) {
-                Room* previousRoom = const_cast<Room*>(path.path[i]);
-                Room* currentRoom = const_cast<Room*>(path.path[i + 1]);
+    std::vector<int> lengths(reduced.getGraph().getNodeCount());
+    for (size_t node = 0; node < lengths.size(); node++) {
+        lengths[node] = reduced.getRoomCount(node);
+    }
 
-                // Calculate how many ants can move
-                int antsInPrevious = previousRoom->getAntsInside();
-                int spaceInCurrent = currentRoom->getCapacity() - currentRoom->getAntsInside();
+    // Find all possible paths from start to end as room indices. Paths with a shortcut
+    // are skipped, as well as paths longer than the number of steps the shortest path
+    // alone needs (with at least one ant per step) to bring every ant
+    PathBuffer found;
+    PathEnumerator enumerator(reduced.getGraph(), reduced.getSource(), reduced.getTarget(), lengths);
+    if (enumerator.getShortestLength() >= 0) {
+        enumerator.limitLength(enumerator.getShortestLength() + std::max(ant_count, 1) - 1);
+    }
+    enumerator.setDeadline(&deadline);
+    ThreadPool& pool = getWorkers();
+    if (pool.getThreadCount() > 1) {
+        enumerator.enumerate(pool, found);
+    } else {
+        enumerator.enumerate(found);
+    }
+    if (enumerator.wasInterrupted()) {
+        interrupted = true;
+        std::cout << "Time limit reached during the path search" << std::endl;
+    } else if (enumerator.wasTruncated()) {
+        std::cout << "Path search stopped at " << PathEnumerator::DEFAULT_MAXIMUM_ROOMS << " rooms of paths" << std::endl;
+    }
 
-                int antsToMove = std::min(antsInPrevious, spaceInCurrent);
+    // Store them as paths of rooms, corridors expanded back to their rooms
+    PathBuffer expanded;
+    reduced.expand(found, expanded);
+    found = PathBuffer();
+    storePaths(expanded, allPaths);
+    flowPaths.clear();
+    pathsSearched = true;
+    if (!enumerator.wasInterrupted() && !enumerator.wasTruncated()) {
+        std::cout << "All paths found" << std::endl;
+        return;
+    }
 
-                // Move ants if possible
-                if (antsToMove > 0) {
-                    for (int j = 0; j < antsToMove; j++) {
-                        this->movesAnt(previousRoom, currentRoom);
-                        someAntMoved = true;
-                    }
-                }
-            }
+    // A partial search only went through its first branches: add the paths of a
+    // maximum flow that it did not find
+    findMaxFlowPaths(flowPaths);
+    std::set<std::vector<const Room*>> missing;
+    for (const Path& path : flowPaths) {
+        missing.insert(path.path);
+    }
+    for (const Path& path : allPaths) {
+        missing.erase(path.path);
+    }
+    size_t added = 0;
+    for (const Path& path : flowPaths) {
+        if (missing.count(path.path)) {
+            allPaths.push_back(path);
+            added++;
         }
-        steps++;
-    } while (someAntMoved); // Continue while ants are still moving
-
-    return steps; // Return the total number of steps needed
+    }
+    std::cout << allPaths.size() - added << " paths found, " << added << " max-flow paths added" << std::endl;
 }
 
 
 
-void Anthill::searchAllPaths() {
+void Anthill::searchMaxFlowPaths() {
     // Check if there are any rooms in the anthill
     if (rooms.empty()) {
         std::cout << "No rooms found" << std::endl;
         return;
     }
 
-    // Get start and end rooms
-    Room* start = findRoomById("Sv");
-    Room* end = findRoomById("Sd");
+    // Decompose a maximum flow into the candidate paths
+    findMaxFlowPaths(allPaths);
+    flowPaths.clear();
+    pathsSearched = true;
+    std::cout << "Max-flow paths found" << std::endl;
+}
+
+
 
-    if (!start || !end) {
-        throw std::runtime_error("Error: Unable to find start or end rooms");
+void Anthill::storePaths(const PathBuffer& buffer, std::vector<Path>& paths) {
+    paths.clear();
+    paths.reserve(buffer.size());
+    for (size_t i = 0; i < buffer.size(); i++) {
+        // Convert the room indices of each path into rooms
+        Path path(buffer.bottlenecks[i]);
+        path.path.reserve(buffer.begins[i + 1] - buffer.begins[i]);
+        for (size_t j = buffer.begins[i]; j < buffer.begins[i + 1]; j++) {
+            path.path.push_back(getRoom(buffer.rooms[j]));
+        }
+        paths.push_back(std::move(path));
     }
+}
 
-    // Create a set to track visited rooms during traversal and avoid infinite loops
-    std::set<const Room*> visited;
-    // Find and store all possible paths from start to end
-    allPaths = start->findAllPaths(end, visited);
-    std::cout << "All paths found" << std::endl;
+
+
+void Anthill::findMaxFlowPaths(std::vector<Path>& paths) {
+    // Get the start room
+    Room* start = getRoom(start_index);
+
+    // Convert the paths the flow was decomposed into
+    paths.clear();
+    for (const std::vector<int>& indices : getRoomFlow().getPaths()) {
+        Path path(start->getCapacity());
+        for (int index : indices) {
+            Room* room = getRoom(index);
+            path.capacityMinimum = std::min(path.capacityMinimum, room->getCapacity());
+            path.path.push_back(room);
+        }
+        paths.push_back(path);
+    }
+}
+
+
+
+const RoomFlow& Anthill::getRoomFlow() {
+    // Compute the flow the first time the bound or the max-flow paths need it
+    if (!room_flow) {
+        room_flow.reset(new RoomFlow(graph, start_index, end_index, ant_count, &deadline));
+        if (room_flow->wasInterrupted()) {
+            interrupted = true;
+            std::cout << "Time limit reached during the maximum flow" << std::endl;
+        }
+    }
+    return *room_flow;
+}
+
+
+
+ThreadPool& Anthill::getWorkers() {
+    // Start the threads the first time a search needs them
+    if (!workers) {
+        workers.reset(new ThreadPool());
+    }
+    return *workers;
 }
 
 
@@ -373,57 +798,317 @@ const std::vector<Path>& Anthill::getOptimalPaths() const {
 
 
 void Anthill::findOptimalPaths() {
-    // Check if there are any paths to optimaze
-    if (allPaths.empty()) {
+    int minimumSteps = INT_MAX;
+    int bestPathCount = 0;
+    bool firstTry = true;
+
+    // No combination can beat the lower bound: the search stops once it is met
+    LowerBound bound(graph, start_index, end_index, ant_count, getRoomFlow());
+    lower_bound = bound.getSteps();
+    if (lower_bound >= 0) {
+        std::cout << "Lower bound : " << lower_bound << " steps (minimum cut " << bound.getMinimumCut()
+                  << ", shortest path " << bound.getShortestLength() << ")" << std::endl;
+    }
+
+    // Candidates come from the searched paths, or lazily from the k-shortest paths
+    // generator (same order as sortAllPaths) when no search was run, built on first use
+    size_t position = 0;
+    bool timeUp = false;
+    std::unique_ptr<KShortestPaths> generator;
+    std::vector<int> found;
+    int bottleneck;
+
+    // Length of the shortest searched path from each position on
+    std::vector<size_t> shortestFrom(allPaths.size() + 1, SIZE_MAX);
+    for (size_t i = allPaths.size(); i-- > 0;) {
+        shortestFrom[i] = std::min(shortestFrom[i + 1], allPaths[i].path.size() - 1);
+    }
+
+    auto nextCandidate = [&](Path& candidate) {
+        if (pathsSearched) {
+            // A path at least as long as the best schedule cannot bring an ant in time:
+            // skip such paths, and stop once all the remaining ones are
+            while (position < allPaths.size()) {
+                if (!firstTry && shortestFrom[position] >= static_cast<size_t>(minimumSteps)) break;
+                const Path& path = allPaths[position++];
+                if (!firstTry && path.path.size() - 1 >= static_cast<size_t>(minimumSteps)) continue;
+                candidate = path;
+                return true;
+            }
+            return false;
+        }
+        // A path at least as long as the best schedule cannot bring an ant in time
+        if (!generator) {
+            generator.reset(new KShortestPaths(graph, start_index, end_index));
+            generator->setDeadline(&deadline);
+        }
+        if (!firstTry) generator->limitLength(minimumSteps - 1);
+        if (generator->next(found, bottleneck)) {
+            candidate = Path(bottleneck);
+            for (int room : found) {
+                candidate.path.push_back(getRoom(room));
+            }
+            return true;
+        }
+        timeUp = generator->wasInterrupted();
+        return false;
+    };
+
+    // Every simulation starts from the same state, copied for each candidate
+    const SimulationState initial(graph, start_index, ant_count);
+
+    // While the combination only shares the start and end rooms, its step count has
+    // a closed form updated with each new path; once two paths share a room, every
+    // larger combination is simulated
+    std::vector<bool> roomUsed(rooms.size(), false);
+    bool disjoint = true;
+    bool bestDisjoint = false;
+    MakespanEvaluator evaluator(ant_count);
+
+    // Try different combinations of paths, adding one candidate at a time.
+    // Candidates are pulled by fixed-size batches whose prefixes are simulated
+    // concurrently, so the result does not depend on the number of threads.
+    const size_t batchSize = 64;
+    optimalPaths.clear();
+    Path candidate(0);
+    bool exhausted = false;
+    while (!exhausted) {
+        size_t batchStart = optimalPaths.size();
+        while (optimalPaths.size() < batchStart + batchSize) {
+            // Past the time limit, the candidates pulled so far are scored and the search stops
+            if (!optimalPaths.empty() && deadline.hasExpired()) {
+                timeUp = true;
+                break;
+            }
+            if (!nextCandidate(candidate)) {
+                exhausted = !timeUp;
+                break;
+            }
+            optimalPaths.push_back(candidate);
+        }
+
+        // Score each new path combination: room-disjoint ones in order with the closed
+        // form, the others by simulating movement on the worker threads
+        std::vector<int> batchSteps(optimalPaths.size() - batchStart);
+        std::vector<bool> batchDisjoint(batchSteps.size());
+        int limit = firstTry ? INT_MAX : minimumSteps;
+        for (size_t i = 0; i < batchSteps.size(); i++) {
+            const Path& path = optimalPaths[batchStart + i];
+            for (size_t j = 1; disjoint && j + 1 < path.path.size(); j++) {
+                int room = path.path[j]->getIndex();
+                disjoint = !roomUsed[room];
+                roomUsed[room] = true;
+            }
+            if (disjoint) {
+                batchSteps[i] = evaluator.addPath(path);
+                disjoint = batchSteps[i] >= 0;
+            }
+            batchDisjoint[i] = disjoint;
+
+            // Simulations stop at the time limit, except the first one, so that there is
+            // always a solution
+            if (!disjoint) {
+                const Deadline* stop = batchStart + i > 0 ? &deadline : nullptr;
+                getWorkers().submit([this, &initial, &batchSteps, batchStart, i, limit, stop] {
+                    SimulationState state = initial;
+                    batchSteps[i] = simulate(graph, optimalPaths, batchStart + i + 1, end_index, ant_count, state,
+                                             nullptr, limit, stop);
+                });
+            }
+        }
+        if (workers) workers->wait();
+
+        for (size_t i = 0; i < batchSteps.size(); i++) {
+            int currentSteps = batchSteps[i];
+            if (currentSteps < 0) {
+                timeUp = true;
+                std::cout << "Test with " << batchStart + i + 1 << " paths : stopped by the time limit" << std::endl;
+                continue;
+            }
+
+            // Update the best solution if the current is better
+            if (firstTry || currentSteps < minimumSteps) {
+                minimumSteps = currentSteps;
+                bestPathCount = static_cast<int>(batchStart + i + 1);
+                bestDisjoint = batchDisjoint[i];
+                firstTry = false;
+            }
+
+            // Simulations stopped at the limit only tell that the combination is not better
+            std::cout << "Test with " << batchStart + i + 1 << " paths : "
+                      << (!batchDisjoint[i] && currentSteps >= limit ? "at least " : "")
+                      << currentSteps << " steps" << std::endl;
+        }
+
+        // Nothing beats a combination meeting the lower bound
+        if (!exhausted && !firstTry && minimumSteps <= lower_bound) {
+            std::cout << "Lower bound reached, stopping the search" << std::endl;
+            break;
+        }
+
+        // Keep the best combination scored so far once the time limit is reached
+        if (timeUp || (!exhausted && deadline.hasExpired())) {
+            timeUp = true;
+            interrupted = true;
+            std::cout << "Time limit reached during the optimisation" << std::endl;
+            break;
+        }
+    }
+
+    // Check if there were any paths to optimize
+    if (firstTry) {
         std::cout << "No paths found" << std::endl;
         return;
     }
 
-    // Get start and end rooms
-    Room* start = findRoomById("Sv");
-    Room* end = findRoomById("Sd");
+    // A subset of the candidates without shared rooms may beat every prefix
+    std::vector<size_t> selection;
+    DisjointPathSelector selector(optimalPaths, ant_count, static_cast<int>(rooms.size()));
+    selector.setDeadline(&deadline);
+    int subsetSteps = minimumSteps > lower_bound ? selector.select(minimumSteps, selection, lower_bound) : -1;
+    if (selector.wasInterrupted() && deadline.hasExpired()) {
+        interrupted = true;
+    }
+    if (subsetSteps >= 0) {
+        std::cout << "Test with a subset of " << selection.size() << " room-disjoint paths : "
+                  << subsetSteps << " steps" << std::endl;
+        std::vector<Path> subset;
+        for (size_t position : selection) {
+            subset.push_back(optimalPaths[position]);
+        }
+        optimalPaths.swap(subset);
+        bestPathCount = static_cast<int>(optimalPaths.size());
+        bestDisjoint = true;
+        minimumSteps = subsetSteps;
+    }
 
-    if (!start || !end) {
-        throw std::runtime_error("Error: Unable to find start or end rooms");
+    // After a search cut short, the max-flow paths together may beat the
+    // combinations tried before the time limit
+    if (timeUp && flowPaths.empty()) {
+        findMaxFlowPaths(flowPaths);
+    }
+    if (!flowPaths.empty()) {
+        SimulationState state = initial;
+        int flowSteps = simulate(graph, flowPaths, flowPaths.size(), end_index, ant_count, state, nullptr,
+                                 minimumSteps);
+        std::cout << "Test with the " << flowPaths.size() << " max-flow paths : "
+                  << (flowSteps >= minimumSteps ? "at least " : "") << flowSteps << " steps" << std::endl;
+        if (flowSteps < minimumSteps) {
+            optimalPaths = flowPaths;
+            bestPathCount = static_cast<int>(optimalPaths.size());
+            bestDisjoint = false;
+            minimumSteps = flowSteps;
+        }
     }
 
-    // Reset simulation by moving all ants back to the start room
-    while (end->getAntsInside() > 0) {
-        movesAnt(end, start);
+    // Store the best combination found, with the number of ants to send through
+    // each path when its step count came from the closed form
+    optimalPaths.resize(bestPathCount, Path(0));
+    if (bestDisjoint) {
+        computeMakespan(optimalPaths, optimalPaths.size(), ant_count, pathQuotas);
+    } else {
+        pathQuotas.clear();
     }
+    best_steps = minimumSteps;
+    proven_optimal = false;
+}
 
-    int minimumSteps = INT_MAX;
-    int bestPathCount = 0;
-    int n_paths = 1;
-    bool firstTry = true;
 
-    // Try different combinations of paths
-    do {
-        // Clear and fill optimalPaths with the current number of paths
-        optimalPaths.clear();
-        for (int i = 0; i < n_paths && i < allPaths.size(); i++) {
-            optimalPaths.push_back(allPaths[i]);
-        }
 
-        // Simulate movement with the current path combination
-        int currentSteps = simulateAntsMovement(start, end);
+void Anthill::findOptimalSchedule() {
+    schedule.clear();
+    if (optimalPaths.empty()) return;
 
-        // Update the best solution if the current is better
-        if (firstTry || currentSteps < minimumSteps) {
-            minimumSteps = currentSteps;
-            bestPathCount = n_paths;
-            firstTry = false;
+    // Nothing is left to search once the time limit is reached
+    if (deadline.hasExpired()) {
+        interrupted = true;
+        std::cout << "Time limit reached, keeping the optimal paths" << std::endl;
+        return;
+    }
+
+    // The optimal paths give a schedule: search for a shorter one, unless they meet the lower bound
+    int pathSteps = simulateAntsMovement(getRoom(start_index), getRoom(end_index));
+    best_steps = pathSteps;
+    if (pathSteps <= lower_bound) {
+        proven_optimal = true;
+        std::cout << "Optimal paths meet the lower bound : " << pathSteps << " steps" << std::endl;
+        return;
+    }
+    TimeExpandedScheduler scheduler(graph, start_index, end_index, ant_count);
+    scheduler.setMaximumArcs(schedule_arc_limit);
+    scheduler.setDeadline(&deadline);
+    int steps = scheduler.solve(pathSteps, schedule, lower_bound);
+
+    if (scheduler.wasInterrupted()) {
+        interrupted = true;
+        if (steps < 0) {
+            std::cout << "Time limit reached, keeping the optimal paths" << std::endl;
+            return;
         }
+        best_steps = steps;
+        std::cout << "Best schedule before the time limit : " << steps << " steps" << std::endl;
+        return;
+    }
+    if (steps < 0) {
+        std::cout << "Optimal schedule too large to search (more than " << schedule_arc_limit
+                  << " arcs), keeping the optimal paths" << std::endl;
+        return;
+    }
+    best_steps = steps;
+    proven_optimal = true;
+    std::cout << "Optimal schedule : " << steps << " steps" << std::endl;
+}
 
-        std::cout << "Test with " << optimalPaths.size() << " paths : " << currentSteps << " steps" << std::endl;
-        n_paths++;
-    } while (n_paths <= allPaths.size());
 
-    // Store the best combination found
-    optimalPaths.clear();
-    for (int i = 0; i < bestPathCount; i++) {
-        optimalPaths.push_back(allPaths[i]);
+
+void Anthill::setTimeLimit(double seconds) {
+    // Every search from now on checks this deadline
+    deadline = Deadline(seconds);
+}
+
+
+
+void Anthill::setScheduleArcLimit(long long arcs) {
+    // Checked here rather than when the schedule search starts
+    if (arcs < 1 || arcs > TimeExpandedScheduler::LARGEST_MAXIMUM_ARCS) {
+        throw std::invalid_argument("The arc limit of the schedule search must be between 1 and " +
+                                    std::to_string(TimeExpandedScheduler::LARGEST_MAXIMUM_ARCS));
+    }
+    schedule_arc_limit = arcs;
+}
+
+
+
+SolveResult Anthill::getSolveResult() const {
+    SolveResult result;
+    result.steps = best_steps;
+    result.lower_bound = lower_bound;
+    result.optimal = best_steps >= 0 && (proven_optimal || best_steps == result.lower_bound);
+    result.interrupted = interrupted;
+    return result;
+}
+
+
+
+void Anthill::displaySolveResult() const {
+    SolveResult result = getSolveResult();
+    if (result.steps < 0) {
+        std::cout << "No solution found" << std::endl;
+        return;
+    }
+
+    // Either the solution is optimal, or at most the gap above the optimum
+    std::cout << "Best solution : " << result.steps << " steps";
+    if (result.optimal) {
+        std::cout << ", optimal";
+    } else {
+        std::cout << ", lower bound " << result.lower_bound
+                  << " (gap " << result.steps - result.lower_bound << ")";
+    }
+    if (result.interrupted) {
+        std::cout << ", time limit reached";
     }
+    std::cout << std::endl;
 }
 
 
@@ -0,0 +1,429 @@
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include "../include/AnthillGenerator.h"
+
+namespace {
+
+/** @brief Ratio of the circumference of a circle to its diameter */
+const double PI = 3.14159265358979323846;
+
+} // namespace
+
+const size_t AnthillGenerator::BUFFER_SIZE = 1 << 20;
+
+
+
+AnthillGenerator::AnthillGenerator(const GeneratorSettings& settings)
+    : settings(settings), room_count(0), length(1), height(1), depth(1), state(settings.seed), file(nullptr),
+      used(0) {
+    // Room indices and capacities are ints once the anthill is loaded
+    if (settings.rooms < 1 || settings.rooms > INT_MAX - 2) {
+        throw std::invalid_argument("The number of rooms must be between 1 and " + std::to_string(INT_MAX - 2));
+    }
+    if (settings.ants < 0 || settings.ants > INT_MAX) {
+        throw std::invalid_argument("The number of ants must be between 0 and " + std::to_string(INT_MAX));
+    }
+    if (settings.max_capacity < 1 || settings.degree < 1 || settings.width < 1) {
+        throw std::invalid_argument("The capacity, degree and width must be at least 1");
+    }
+    if (settings.max_capacity > INT_MAX / settings.degree) {
+        throw std::invalid_argument("The capacity of the hubs would exceed " + std::to_string(INT_MAX));
+    }
+
+    // The shape is rounded down to fit the number of rooms asked, never above it
+    computeShape();
+    if (room_count < 1 || room_count > settings.rooms) {
+        throw std::invalid_argument("The shape needs " + std::to_string(room_count) + " rooms, more than the " +
+                                    std::to_string(settings.rooms) + " asked");
+    }
+}
+
+
+
+long long AnthillGenerator::write(const std::string& filename) {
+    // Open the output, the standard output being flushed first
+    if (filename.empty()) {
+        std::cout.flush();
+        file = stdout;
+    } else {
+        file = std::fopen(filename.c_str(), "wb");
+        if (!file) {
+            throw std::runtime_error("Could not open file " + filename);
+        }
+    }
+    buffer.assign(BUFFER_SIZE, 0);
+    used = 0;
+    state = settings.seed;
+
+    try {
+        switch (settings.family) {
+            case AnthillFamily::Corridors:
+                writeCorridors();
+                break;
+            case AnthillFamily::Grid2D:
+            case AnthillFamily::Grid3D:
+                writeGrid();
+                break;
+            case AnthillFamily::Geometric:
+                writeGeometric();
+                break;
+            case AnthillFamily::HubAndSpoke:
+                writeHubAndSpoke();
+                break;
+        }
+        flush();
+        if (std::fflush(file) != 0) {
+            throw std::runtime_error("Could not write the anthill");
+        }
+    } catch (...) {
+        if (file != stdout) std::fclose(file);
+        file = nullptr;
+        throw;
+    }
+    if (file != stdout && std::fclose(file) != 0) {
+        file = nullptr;
+        throw std::runtime_error("Could not write the anthill");
+    }
+    file = nullptr;
+    return room_count + 2;
+}
+
+
+
+bool AnthillGenerator::parseFamily(const std::string& name, AnthillFamily& family) {
+    // Names of the command line
+    if (name == "corridors") {
+        family = AnthillFamily::Corridors;
+    } else if (name == "grid2d") {
+        family = AnthillFamily::Grid2D;
+    } else if (name == "grid3d") {
+        family = AnthillFamily::Grid3D;
+    } else if (name == "geometric") {
+        family = AnthillFamily::Geometric;
+    } else if (name == "hub") {
+        family = AnthillFamily::HubAndSpoke;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+
+
+void AnthillGenerator::computeShape() {
+    long long rooms = settings.rooms;
+    switch (settings.family) {
+        case AnthillFamily::Corridors:
+            // Layers of width rooms, as many as fit
+            height = std::min<long long>(settings.width, rooms);
+            length = rooms / height;
+            room_count = length * height;
+            break;
+        case AnthillFamily::Grid2D:
+        case AnthillFamily::Grid3D:
+            // The sizes are as close as possible, the first one taking what remains
+            if (settings.family == AnthillFamily::Grid3D) {
+                depth = static_cast<long long>(std::cbrt(static_cast<double>(rooms)));
+                while ((depth + 1) * (depth + 1) * (depth + 1) <= rooms) depth++;
+                while (depth > 1 && depth * depth * depth > rooms) depth--;
+            }
+            height = static_cast<long long>(std::sqrt(static_cast<double>(rooms / depth)));
+            while ((height + 1) * (height + 1) <= rooms / depth) height++;
+            while (height > 1 && height * height > rooms / depth) height--;
+            length = rooms / (depth * height);
+            room_count = length * height * depth;
+            break;
+        case AnthillFamily::Geometric:
+            // One room per point
+            room_count = rooms;
+            break;
+        case AnthillFamily::HubAndSpoke:
+            // Groups of degree corridors of width rooms and a hub, as many as fit (at
+            // least one, the constructor refusing a group larger than the rooms asked)
+            length = std::max(1LL, rooms / (static_cast<long long>(settings.degree) * settings.width + 1));
+            room_count = length * (static_cast<long long>(settings.degree) * settings.width + 1);
+            break;
+    }
+}
+
+
+
+void AnthillGenerator::writeCorridors() {
+    // Layers of width rooms, room (layer, position) numbered 1 + layer * width + position
+    long long width = height;
+    long long layers = length;
+    long long degree = std::min<long long>(settings.degree, width);
+    writeCounts();
+    for (long long room = 1; room <= room_count; room++) {
+        writeRoom(room, randomCapacity());
+    }
+
+    // Sv leads to the first layer and the last layer to Sd
+    for (long long position = 0; position < width; position++) {
+        writeTunnel(0, 1 + position);
+        writeTunnel(1 + (layers - 1) * width + position, room_count + 1);
+    }
+
+    // Each room leads to the room at its position in the next layer and to random ones
+    std::vector<long long> targets;
+    for (long long layer = 0; layer + 1 < layers; layer++) {
+        for (long long position = 0; position < width; position++) {
+            targets.assign(1, position);
+            for (long long i = 1; i < degree; i++) {
+                targets.push_back(randomBelow(width));
+            }
+            std::sort(targets.begin(), targets.end());
+            targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+            for (long long target : targets) {
+                writeTunnel(1 + layer * width + position, 1 + (layer + 1) * width + target);
+            }
+        }
+    }
+}
+
+
+
+void AnthillGenerator::writeGrid() {
+    // Grid of length * height * depth rooms, depth being 1 in two dimensions
+    writeCounts();
+    for (long long room = 1; room <= room_count; room++) {
+        writeRoom(room, randomCapacity());
+    }
+
+    // Room (x, y, z) is numbered 1 + (x * height + y) * depth + z, linked to its next neighbors
+    long long slice = height * depth;
+    for (long long x = 0; x < length; x++) {
+        for (long long y = 0; y < height; y++) {
+            for (long long z = 0; z < depth; z++) {
+                long long room = 1 + (x * height + y) * depth + z;
+                if (x == 0) writeTunnel(0, room);
+                if (x + 1 < length) writeTunnel(room, room + slice);
+                if (y + 1 < height) writeTunnel(room, room + depth);
+                if (z + 1 < depth) writeTunnel(room, room + 1);
+                if (x + 1 == length) writeTunnel(room, room_count + 1);
+            }
+        }
+    }
+}
+
+
+
+void AnthillGenerator::writeGeometric() {
+    // Points closer than the radius are linked, giving degree neighbors on average but
+    // at least ln(rooms) + 1, above which the graph is connected with high probability
+    double neighbors_mean = std::max(static_cast<double>(settings.degree), std::log(static_cast<double>(room_count)) + 1);
+    double radius = std::min(1.0, std::sqrt(neighbors_mean / (PI * static_cast<double>(room_count))));
+    long long cells = std::max(1LL, std::min(static_cast<long long>(1.0 / radius),
+                                             static_cast<long long>(std::sqrt(static_cast<double>(room_count)))));
+
+    // Count the points of each cell, then draw them again into their cell (counting sort)
+    auto cellOf = [&](double x, double y) {
+        long long column = std::min(cells - 1, static_cast<long long>(x * cells));
+        long long row = std::min(cells - 1, static_cast<long long>(y * cells));
+        return row * cells + column;
+    };
+    auto randomUnit = [&]() { return static_cast<double>(nextRandom() >> 11) * (1.0 / 9007199254740992.0); };
+    std::vector<long long> cell_begin(cells * cells + 1, 0);
+    uint64_t points_seed = state;
+    for (long long point = 0; point < room_count; point++) {
+        double x = randomUnit();
+        double y = randomUnit();
+        cell_begin[cellOf(x, y) + 1]++;
+    }
+    for (long long cell = 0; cell < cells * cells; cell++) {
+        cell_begin[cell + 1] += cell_begin[cell];
+    }
+    std::vector<double> xs(room_count);
+    std::vector<double> ys(room_count);
+    std::vector<long long> position(cell_begin.begin(), cell_begin.end() - 1);
+    state = points_seed;
+    for (long long point = 0; point < room_count; point++) {
+        double x = randomUnit();
+        double y = randomUnit();
+        long long slot = position[cellOf(x, y)]++;
+        xs[slot] = x;
+        ys[slot] = y;
+    }
+
+    // Rooms follow the cells, point i being room i + 1
+    writeCounts();
+    for (long long room = 1; room <= room_count; room++) {
+        writeRoom(room, randomCapacity());
+    }
+
+    // Sv is on the left side of the square and Sd on the right side
+    double squared = radius * radius;
+    for (long long point = 0; point < room_count; point++) {
+        if (xs[point] < radius) writeTunnel(0, point + 1);
+        if (xs[point] > 1.0 - radius) writeTunnel(point + 1, room_count + 1);
+    }
+
+    // Compare each point with the later points of its cell and the points of four neighbor cells
+    const long long neighbors[4][2] = {{1, 0}, {-1, 1}, {0, 1}, {1, 1}};
+    for (long long row = 0; row < cells; row++) {
+        for (long long column = 0; column < cells; column++) {
+            long long cell = row * cells + column;
+            for (long long point = cell_begin[cell]; point < cell_begin[cell + 1]; point++) {
+                for (long long other = point + 1; other < cell_begin[cell + 1]; other++) {
+                    double dx = xs[point] - xs[other];
+                    double dy = ys[point] - ys[other];
+                    if (dx * dx + dy * dy <= squared) writeTunnel(point + 1, other + 1);
+                }
+                for (const auto& neighbor : neighbors) {
+                    long long next_column = column + neighbor[0];
+                    long long next_row = row + neighbor[1];
+                    if (next_column < 0 || next_column >= cells || next_row >= cells) continue;
+                    long long next_cell = next_row * cells + next_column;
+                    for (long long other = cell_begin[next_cell]; other < cell_begin[next_cell + 1]; other++) {
+                        double dx = xs[point] - xs[other];
+                        double dy = ys[point] - ys[other];
+                        if (dx * dx + dy * dy <= squared) writeTunnel(point + 1, other + 1);
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+
+void AnthillGenerator::writeHubAndSpoke() {
+    // Groups of degree corridors of width rooms followed by their hub
+    long long width = settings.width;
+    long long degree = settings.degree;
+    long long group = degree * width + 1;
+    long long groups = length;
+    writeCounts();
+    for (long long room = 1; room <= room_count; room++) {
+        bool hub = room % group == 0;
+        writeRoom(room, hub ? static_cast<long long>(randomCapacity()) * degree : randomCapacity());
+    }
+
+    for (long long index = 0; index < groups; index++) {
+        long long base = 1 + index * group;
+        long long hub = base + degree * width;
+
+        // Each corridor goes from Sv to Sd, its hub joining it at a random room
+        for (long long corridor = 0; corridor < degree; corridor++) {
+            long long first = base + corridor * width;
+            writeTunnel(0, first);
+            for (long long room = first; room + 1 < first + width; room++) {
+                writeTunnel(room, room + 1);
+            }
+            writeTunnel(first + width - 1, room_count + 1);
+            writeTunnel(hub, first + randomBelow(width));
+        }
+
+        // Hubs are chained, so ants can switch to the corridors of another group
+        if (index + 1 < groups) writeTunnel(hub, hub + group);
+    }
+}
+
+
+
+void AnthillGenerator::writeCounts() {
+    // "r=" counts Sv and Sd like the bundled anthills
+    append("r=", 2);
+    appendNumber(room_count + 2);
+    append("\nf=", 3);
+    appendNumber(settings.ants);
+    append("\n", 1);
+}
+
+
+
+void AnthillGenerator::writeRoom(long long room, long long capacity) {
+    // "S<i> { <capacity> }"
+    appendRoom(room);
+    append(" { ", 3);
+    appendNumber(capacity);
+    append(" }\n", 3);
+}
+
+
+
+void AnthillGenerator::writeTunnel(long long from, long long to) {
+    // "<A> - <B>"
+    appendRoom(from);
+    append(" - ", 3);
+    appendRoom(to);
+    append("\n", 1);
+}
+
+
+
+void AnthillGenerator::appendRoom(long long room) {
+    // Sv, Sd, or S followed by the number of the room
+    if (room == 0) {
+        append("Sv", 2);
+    } else if (room == room_count + 1) {
+        append("Sd", 2);
+    } else {
+        append("S", 1);
+        appendNumber(room);
+    }
+}
+
+
+
+void AnthillGenerator::appendNumber(long long value) {
+    // Digits from the last one, then in order
+    char digits[24];
+    char* cursor = digits + sizeof(digits);
+    unsigned long long magnitude = value < 0 ? 0ULL - static_cast<unsigned long long>(value)
+                                             : static_cast<unsigned long long>(value);
+    do {
+        *--cursor = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0) *--cursor = '-';
+    append(cursor, digits + sizeof(digits) - cursor);
+}
+
+
+
+void AnthillGenerator::append(const char* text, size_t length) {
+    // Lines are short, so they always fit once the buffer is written out
+    if (used + length > buffer.size()) flush();
+    std::memcpy(buffer.data() + used, text, length);
+    used += length;
+}
+
+
+
+void AnthillGenerator::flush() {
+    // One write for the whole buffer
+    if (used > 0 && std::fwrite(buffer.data(), 1, used, file) != used) {
+        used = 0;
+        throw std::runtime_error("Could not write the anthill");
+    }
+    used = 0;
+}
+
+
+
+uint64_t AnthillGenerator::nextRandom() {
+    // splitmix64
+    uint64_t value = (state += 0x9E3779B97F4A7C15ULL);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+
+
+long long AnthillGenerator::randomBelow(long long bound) {
+    // The modulo bias is negligible for the bounds used here
+    return static_cast<long long>(nextRandom() % static_cast<uint64_t>(bound));
+}
+
+
+
+int AnthillGenerator::randomCapacity() {
+    // Between 1 and the maximum capacity
+    return 1 + static_cast<int>(randomBelow(settings.max_capacity));
+}
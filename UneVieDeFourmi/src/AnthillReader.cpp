@@ -0,0 +1,163 @@
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include "../include/AnthillReader.h"
+#include "../include/MappedFile.h"
+
+namespace {
+
+bool isBlank(char c) {
+    // Spaces, tabs and carriage returns (Windows line endings) separate words
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+void splitWords(const char* cursor, const char* end, std::vector<std::string>& words) {
+    // Every run of characters between blanks is a word
+    words.clear();
+    while (cursor < end) {
+        while (cursor < end && isBlank(*cursor)) cursor++;
+        const char* first = cursor;
+        while (cursor < end && !isBlank(*cursor)) cursor++;
+        if (cursor > first) words.emplace_back(first, cursor - first);
+    }
+}
+
+bool readCount(const char* cursor, const char* end, int& value) {
+    // Decimal digits between optional blanks, at most INT_MAX
+    while (cursor < end && isBlank(*cursor)) cursor++;
+    while (end > cursor && isBlank(end[-1])) end--;
+    long long number = 0;
+    for (const char* digit = cursor; digit < end; digit++) {
+        if (*digit < '0' || *digit > '9') return false;
+        number = number * 10 + (*digit - '0');
+        if (number > INT_MAX) return false;
+    }
+    value = static_cast<int>(number);
+    return end > cursor;
+}
+
+} // namespace
+
+
+
+AnthillReader::AnthillReader(const std::string& filename) : start(0), end(0), ant_count(0) {
+    MappedFile file(filename);
+    const char* cursor = file.begin();
+    long long line_number = 0;
+    std::vector<std::string> words;
+    std::vector<std::pair<std::string, std::string>> tunnels;
+    std::unordered_map<std::string, int> room_index;
+
+    // Name the line that cannot be read
+    auto fail = [&](const std::string& reason) {
+        throw std::runtime_error("Invalid anthill " + filename + ", line " + std::to_string(line_number) + " : " +
+                                 reason);
+    };
+
+    // Rooms keep the first declaration of their identifier
+    auto addRoom = [&](const std::string& id, int capacity) {
+        if (room_index.count(id)) return;
+        room_index.emplace(id, graph.addNode(capacity));
+        room_ids.push_back(id);
+    };
+
+    while (cursor < file.end()) {
+        const char* line = cursor;
+        const char* line_end = static_cast<const char*>(std::memchr(cursor, '\n', file.end() - cursor));
+        if (!line_end) line_end = file.end();
+        cursor = line_end + 1;
+        line_number++;
+
+        // The numbers of rooms and ants come first, the ants starting in Sv
+        if (line_number <= 2) {
+            const char* prefix = line_number == 1 ? "r=" : "f=";
+            int count = 0;
+            if (line_end - line < 2 || std::memcmp(line, prefix, 2) != 0 || !readCount(line + 2, line_end, count)) {
+                fail(std::string("expected ") + prefix + "<number>");
+            }
+            if (line_number == 2) {
+                ant_count = count;
+                addRoom("Sv", count);
+                start = room_index["Sv"];
+            }
+            continue;
+        }
+
+        splitWords(line, line_end, words);
+        if (words.empty()) continue;
+        if (std::memchr(line, '-', line_end - line)) {
+            // Tunnel "<A> - <B>", linked once every room is known
+            if (words.size() != 3 || words[1] != "-") {
+                fail("expected <room> - <room>");
+            }
+            tunnels.emplace_back(words[0], words[2]);
+        } else if (!std::memchr(line, '=', line_end - line)) {
+            // Room "<id>" or "<id> { <capacity> }"
+            int capacity = 1;
+            const char* open = static_cast<const char*>(std::memchr(line, '{', line_end - line));
+            if (open) {
+                const char* close = static_cast<const char*>(std::memchr(open, '}', line_end - open));
+                if (!close || !readCount(open + 1, close, capacity) || words[0].find('{') != std::string::npos) {
+                    fail("expected <room> { <capacity> }");
+                }
+            } else if (words.size() != 1) {
+                fail("expected <room> { <capacity> }");
+            }
+            addRoom(words[0], capacity);
+        }
+    }
+    if (line_number < 2) {
+        line_number++;
+        fail(line_number == 1 ? "expected r=<number>" : "expected f=<number>");
+    }
+
+    // Sd comes last, then the tunnels between declared rooms, both ways
+    addRoom("Sd", static_cast<int>(ant_count));
+    end = room_index["Sd"];
+    for (const auto& tunnel : tunnels) {
+        auto from = room_index.find(tunnel.first);
+        auto to = room_index.find(tunnel.second);
+        if (from != room_index.end() && to != room_index.end()) {
+            graph.addEdge(from->second, to->second);
+            graph.addEdge(to->second, from->second);
+        }
+    }
+    graph.build();
+}
+
+
+
+const Graph& AnthillReader::getGraph() const {
+    // Return the rooms and tunnels
+    return graph;
+}
+
+
+
+const std::vector<std::string>& AnthillReader::getRoomIds() const {
+    // Return the identifiers, by index
+    return room_ids;
+}
+
+
+
+int AnthillReader::getStart() const {
+    // Return the index of Sv
+    return start;
+}
+
+
+
+int AnthillReader::getEnd() const {
+    // Return the index of Sd
+    return end;
+}
+
+
+
+long long AnthillReader::getAntCount() const {
+    // Return the number of ants
+    return ant_count;
+}
@@ -0,0 +1,304 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include "../include/BinarySchedule.h"
+
+namespace {
+
+/** @brief Magic bytes starting a binary solution */
+const char HEADER_MAGIC[4] = {'U', 'V', 'D', 'S'};
+
+/** @brief Magic bytes ending a binary solution, after the step index */
+const char TRAILER_MAGIC[4] = {'U', 'V', 'D', 'I'};
+
+/** @brief Version of the format */
+const unsigned char FORMAT_VERSION = 1;
+
+/** @brief Size of the trailer: index offset, step count and magic */
+const size_t TRAILER_SIZE = 8 + 8 + 4;
+
+/** @brief Size of the output buffer, in bytes */
+const size_t BUFFER_SIZE = 1 << 20;
+
+uint64_t zigzag(long long value) {
+    // Small differences of either sign become small unsigned numbers
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+long long unzigzag(uint64_t value) {
+    // Inverse of zigzag
+    return static_cast<long long>(value >> 1) ^ -static_cast<long long>(value & 1);
+}
+
+} // namespace
+
+
+
+BinaryScheduleWriter::BinaryScheduleWriter(const std::string& filename, const std::vector<std::string>& room_ids,
+                                           long long ant_count, int start, int end)
+    : file(std::fopen(filename.c_str(), "wb")), buffer(BUFFER_SIZE), used(0), offset(0), finished(false) {
+    if (!file) {
+        throw std::runtime_error("Could not open file " + filename);
+    }
+
+    // Magic, version, room table, ants and the start and end rooms
+    append(reinterpret_cast<const unsigned char*>(HEADER_MAGIC), sizeof(HEADER_MAGIC));
+    append(&FORMAT_VERSION, 1);
+    appendVarint(room_ids.size());
+    for (const std::string& id : room_ids) {
+        appendVarint(id.size());
+        append(reinterpret_cast<const unsigned char*>(id.data()), id.size());
+    }
+    appendVarint(ant_count);
+    appendVarint(start);
+    appendVarint(end);
+}
+
+
+
+BinaryScheduleWriter::~BinaryScheduleWriter() {
+    // Errors cannot be reported from a destructor: finish what can be
+    try {
+        if (!finished) finish();
+    } catch (const std::exception&) {
+    }
+    std::fclose(file);
+}
+
+
+
+void BinaryScheduleWriter::writeStep(const std::vector<AntMove>& moves) {
+    step_offsets.push_back(offset);
+
+    // Number of single-ant moves, then each move with its ant relative to the previous one
+    uint64_t count = 0;
+    for (const AntMove& move : moves) {
+        count += move.ants;
+    }
+    appendVarint(count);
+
+    long long previous = 0;
+    for (const AntMove& move : moves) {
+        for (long long ant = move.first_ant; ant < move.first_ant + move.ants; ant++) {
+            appendVarint(zigzag(ant - previous));
+            appendVarint(move.from);
+            appendVarint(move.to);
+            previous = ant;
+        }
+    }
+}
+
+
+
+void BinaryScheduleWriter::finish() {
+    finished = true;
+
+    // Step index, then where it starts and how many steps it holds
+    uint64_t index_offset = offset;
+    for (uint64_t step_offset : step_offsets) {
+        appendFixed(step_offset);
+    }
+    appendFixed(index_offset);
+    appendFixed(step_offsets.size());
+    append(reinterpret_cast<const unsigned char*>(TRAILER_MAGIC), sizeof(TRAILER_MAGIC));
+
+    flush();
+    if (std::fflush(file) != 0) {
+        throw std::runtime_error("Could not write the solution");
+    }
+}
+
+
+
+void BinaryScheduleWriter::append(const unsigned char* bytes, size_t length) {
+    offset += length;
+    while (length > 0) {
+        if (used == buffer.size()) flush();
+
+        // Copy as much as fits, the rest after writing out the buffer
+        size_t chunk = std::min(length, buffer.size() - used);
+        std::memcpy(buffer.data() + used, bytes, chunk);
+        used += chunk;
+        bytes += chunk;
+        length -= chunk;
+    }
+}
+
+
+
+void BinaryScheduleWriter::appendVarint(uint64_t value) {
+    // Seven bits per byte, the high bit set on every byte but the last
+    unsigned char bytes[10];
+    size_t length = 0;
+    while (value >= 0x80) {
+        bytes[length++] = static_cast<unsigned char>(value | 0x80);
+        value >>= 7;
+    }
+    bytes[length++] = static_cast<unsigned char>(value);
+    append(bytes, length);
+}
+
+
+
+void BinaryScheduleWriter::appendFixed(uint64_t value) {
+    // Least significant byte first, whatever the byte order of the machine
+    unsigned char bytes[8];
+    for (int i = 0; i < 8; i++) {
+        bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+    append(bytes, sizeof(bytes));
+}
+
+
+
+void BinaryScheduleWriter::flush() {
+    // One write for the whole buffer
+    if (used > 0 && std::fwrite(buffer.data(), 1, used, file) != used) {
+        used = 0;
+        throw std::runtime_error("Could not write the solution");
+    }
+    used = 0;
+}
+
+
+
+BinaryScheduleReader::BinaryScheduleReader(const char* content_begin, const char* content_end)
+    : data(reinterpret_cast<const unsigned char*>(content_begin)),
+      data_end(reinterpret_cast<const unsigned char*>(content_end)),
+      index(nullptr), ant_count(0), start(0), end(0), step_count(0) {
+    size_t size = data_end - data;
+    if (size < sizeof(HEADER_MAGIC) + 1 + TRAILER_SIZE || std::memcmp(data, HEADER_MAGIC, sizeof(HEADER_MAGIC)) != 0 ||
+        std::memcmp(data_end - sizeof(TRAILER_MAGIC), TRAILER_MAGIC, sizeof(TRAILER_MAGIC)) != 0) {
+        throw std::runtime_error("Invalid binary solution : missing magic");
+    }
+    if (data[sizeof(HEADER_MAGIC)] != FORMAT_VERSION) {
+        throw std::runtime_error("Invalid binary solution : unknown version");
+    }
+
+    // Room table, ants and the start and end rooms
+    const unsigned char* cursor = data + sizeof(HEADER_MAGIC) + 1;
+    const unsigned char* trailer = data_end - TRAILER_SIZE;
+    uint64_t room_count = readVarint(cursor, trailer);
+    if (room_count > static_cast<uint64_t>(trailer - cursor)) {
+        throw std::runtime_error("Invalid binary solution : truncated room table");
+    }
+    room_ids.reserve(room_count);
+    for (uint64_t i = 0; i < room_count; i++) {
+        uint64_t length = readVarint(cursor, trailer);
+        if (length > static_cast<uint64_t>(trailer - cursor)) {
+            throw std::runtime_error("Invalid binary solution : truncated room table");
+        }
+        room_ids.emplace_back(reinterpret_cast<const char*>(cursor), length);
+        cursor += length;
+    }
+    ant_count = static_cast<long long>(readVarint(cursor, trailer));
+    uint64_t start_room = readVarint(cursor, trailer);
+    uint64_t end_room = readVarint(cursor, trailer);
+    if (start_room >= room_count || end_room >= room_count) {
+        throw std::runtime_error("Invalid binary solution : unknown start or end room");
+    }
+    start = static_cast<int>(start_room);
+    end = static_cast<int>(end_room);
+
+    // The trailer locates the step index
+    uint64_t index_offset = readFixed(trailer);
+    uint64_t steps = readFixed(trailer + 8);
+    if (index_offset > size - TRAILER_SIZE || steps != (size - TRAILER_SIZE - index_offset) / 8 ||
+        (size - TRAILER_SIZE - index_offset) % 8 != 0) {
+        throw std::runtime_error("Invalid binary solution : corrupted step index");
+    }
+    index = data + index_offset;
+    step_count = static_cast<long long>(steps);
+}
+
+
+
+const std::vector<std::string>& BinaryScheduleReader::getRoomIds() const {
+    // Return the room table
+    return room_ids;
+}
+
+
+
+long long BinaryScheduleReader::getAntCount() const {
+    // Return the number of ants
+    return ant_count;
+}
+
+
+
+int BinaryScheduleReader::getStart() const {
+    // Return the index of the start room
+    return start;
+}
+
+
+
+int BinaryScheduleReader::getEnd() const {
+    // Return the index of the end room
+    return end;
+}
+
+
+
+long long BinaryScheduleReader::getStepCount() const {
+    // Return the number of entries of the step index
+    return step_count;
+}
+
+
+
+void BinaryScheduleReader::readStep(long long step, std::vector<BinaryMove>& moves) const {
+    moves.clear();
+    if (step < 1 || step > step_count) {
+        throw std::runtime_error("Invalid step " + std::to_string(step));
+    }
+
+    // Seek the record through the index; it ends before the index at the latest
+    uint64_t record = readFixed(index + 8 * (step - 1));
+    if (record >= static_cast<uint64_t>(index - data)) {
+        throw std::runtime_error("Invalid binary solution : corrupted step index");
+    }
+    const unsigned char* cursor = data + record;
+    uint64_t count = readVarint(cursor, index);
+    if (count > static_cast<uint64_t>(index - cursor) / 3) {
+        throw std::runtime_error("Invalid binary solution : truncated step");
+    }
+
+    moves.reserve(count);
+    long long ant = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        ant += unzigzag(readVarint(cursor, index));
+        uint64_t from = readVarint(cursor, index);
+        uint64_t to = readVarint(cursor, index);
+        if (from >= room_ids.size() || to >= room_ids.size()) {
+            throw std::runtime_error("Invalid binary solution : unknown room");
+        }
+        moves.push_back({ant, static_cast<int>(from), static_cast<int>(to)});
+    }
+}
+
+
+
+uint64_t BinaryScheduleReader::readVarint(const unsigned char*& cursor, const unsigned char* limit) const {
+    // Seven bits per byte, until a byte without the high bit
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (cursor >= limit) break;
+        unsigned char byte = *cursor++;
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return value;
+    }
+    throw std::runtime_error("Invalid binary solution : truncated number");
+}
+
+
+
+uint64_t BinaryScheduleReader::readFixed(const unsigned char* cursor) {
+    // Least significant byte first
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; i--) {
+        value = (value << 8) | cursor[i];
+    }
+    return value;
+}
@@ -0,0 +1,26 @@
+#include <algorithm>
+#include "../include/Deadline.h"
+
+Deadline::Deadline() : limited(false) {}
+
+
+
+Deadline::Deadline(double seconds) : limited(true) {
+    // A duration past the last time point the clock can hold ends there instead of
+    // overflowing; a second of margin covers the rounding of the conversion
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    const std::chrono::duration<double> left = std::chrono::steady_clock::time_point::max() - now;
+    if (!(seconds < left.count() - 1)) {
+        end = std::chrono::steady_clock::time_point::max();
+        return;
+    }
+    end = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double>(std::max(seconds, 0.0)));
+}
+
+
+
+bool Deadline::hasExpired() const {
+    // An unlimited deadline never reads the clock
+    return limited && std::chrono::steady_clock::now() >= end;
+}
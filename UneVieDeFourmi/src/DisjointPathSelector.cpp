@@ -0,0 +1,102 @@
+#include <algorithm>
+#include "../include/Room.h"
+#include "../include/DisjointPathSelector.h"
+
+const size_t DisjointPathSelector::MAXIMUM_CANDIDATES = 1024;
+const long long DisjointPathSelector::MAXIMUM_NODES = 20000;
+
+
+
+DisjointPathSelector::DisjointPathSelector(const std::vector<Path>& candidates, int ant_count, int room_count)
+    : candidates(candidates), candidate_count(std::min(candidates.size(), MAXIMUM_CANDIDATES)),
+      ant_count(ant_count), conflicts(candidate_count), blocked(candidate_count, 0),
+      best_steps(0), lower_bound(0), nodes(0), deadline(nullptr) {
+    // Gather the candidates going through each room, start and end rooms excepted
+    std::vector<std::vector<size_t>> users(room_count);
+    for (size_t i = 0; i < candidate_count; i++) {
+        const std::vector<const Room*>& path = candidates[i].path;
+        for (size_t j = 1; j + 1 < path.size(); j++) {
+            users[path[j]->getIndex()].push_back(i);
+        }
+    }
+
+    // Two candidates conflict when they share one of these rooms
+    for (const auto& room_users : users) {
+        for (size_t a = 0; a < room_users.size(); a++) {
+            for (size_t b = a + 1; b < room_users.size(); b++) {
+                conflicts[room_users[a]].push_back(room_users[b]);
+            }
+        }
+    }
+    for (auto& later : conflicts) {
+        std::sort(later.begin(), later.end());
+        later.erase(std::unique(later.begin(), later.end()), later.end());
+    }
+}
+
+
+
+int DisjointPathSelector::select(int upper, std::vector<size_t>& selection, int lower) {
+    best_steps = upper;
+    lower_bound = lower;
+    best_selection.clear();
+    chosen.clear();
+    nodes = 0;
+
+    branch(0, MakespanEvaluator(ant_count));
+
+    selection = best_selection;
+    return best_selection.empty() ? -1 : best_steps;
+}
+
+
+
+void DisjointPathSelector::setDeadline(const Deadline* deadline) {
+    // The search stops once this deadline expires
+    this->deadline = deadline;
+}
+
+
+
+bool DisjointPathSelector::wasInterrupted() const {
+    // The count goes past the limit only when the search was stopped
+    return nodes > MAXIMUM_NODES;
+}
+
+
+
+void DisjointPathSelector::branch(size_t first, const MakespanEvaluator& evaluator) {
+    if (++nodes > MAXIMUM_NODES) return;
+    if ((nodes & 255) == 0 && deadline && deadline->hasExpired()) {
+        nodes = MAXIMUM_NODES + 1;
+        return;
+    }
+
+    // Bound: the current subset with every remaining candidate it does not conflict with
+    MakespanEvaluator bound = evaluator;
+    for (size_t i = first; i < candidate_count; i++) {
+        if (blocked[i] == 0) bound.addPath(candidates[i]);
+    }
+    int lower = bound.getMakespan();
+    if (lower < 0 || lower >= best_steps) return;
+
+    // Nothing beats a subset meeting the lower bound
+    for (size_t i = first; i < candidate_count && nodes <= MAXIMUM_NODES && best_steps > lower_bound; i++) {
+        // Skip conflicting candidates and paths too long to beat the best subset
+        if (blocked[i] > 0 || candidates[i].path.size() - 1 >= static_cast<size_t>(best_steps)) continue;
+
+        MakespanEvaluator next = evaluator;
+        int steps = next.addPath(candidates[i]);
+        chosen.push_back(i);
+        if (steps >= 0 && steps < best_steps) {
+            best_steps = steps;
+            best_selection = chosen;
+        }
+
+        // Explore the subsets holding this candidate, then the ones without it
+        for (size_t other : conflicts[i]) blocked[other]++;
+        branch(i + 1, next);
+        for (size_t other : conflicts[i]) blocked[other]--;
+        chosen.pop_back();
+    }
+}
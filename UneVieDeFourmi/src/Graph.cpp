@@ -0,0 +1,136 @@
+#include "../include/Graph.h"
+
+
+
+Graph::Graph() {
+    // Start with the graph's own, empty, arrays
+    attachArcs();
+}
+
+
+
+Graph::Graph(const Graph& other)
+    : offsets(other.offsets), neighbors(other.neighbors), capacity(other.capacity), occupancy(other.occupancy),
+      pending_arcs(other.pending_arcs), arc_offsets(other.arc_offsets), arc_targets(other.arc_targets),
+      viewing(other.viewing) {
+    // Owned arrays were copied, so the copy points at its own
+    if (!viewing) attachArcs();
+}
+
+
+
+Graph& Graph::operator=(const Graph& other) {
+    // Same as the copy constructor
+    offsets = other.offsets;
+    neighbors = other.neighbors;
+    capacity = other.capacity;
+    occupancy = other.occupancy;
+    pending_arcs = other.pending_arcs;
+    arc_offsets = other.arc_offsets;
+    arc_targets = other.arc_targets;
+    viewing = other.viewing;
+    if (!viewing) attachArcs();
+    return *this;
+}
+
+
+
+int Graph::addNode(int node_capacity) {
+    // The new node has no arc yet, the viewed arrays being copied to grow them
+    if (viewing) ownArcs();
+    capacity.push_back(node_capacity);
+    occupancy.push_back(0);
+    offsets.push_back(offsets.back());
+    attachArcs();
+    return static_cast<int>(capacity.size()) - 1;
+}
+
+
+
+void Graph::addEdge(int from, int to) {
+    // Keep the arc until the next layout
+    pending_arcs.push_back(std::make_pair(from, to));
+}
+
+
+
+void Graph::build() {
+    int node_count = getNodeCount();
+
+    // Gather the arcs already laid out with the pending ones
+    std::vector<std::pair<int, int>> arcs;
+    arcs.reserve(getArcCount() + pending_arcs.size());
+    for (int node = 0; node < node_count; node++) {
+        for (int arc = arc_offsets[node]; arc < arc_offsets[node + 1]; arc++) {
+            arcs.push_back(std::make_pair(node, arc_targets[arc]));
+        }
+    }
+    arcs.insert(arcs.end(), pending_arcs.begin(), pending_arcs.end());
+    pending_arcs.clear();
+    pending_arcs.shrink_to_fit();
+
+    // Count the arcs of each node, then turn the counts into offsets
+    offsets.assign(node_count + 1, 0);
+    for (const auto& arc : arcs) {
+        offsets[arc.first + 1]++;
+    }
+    for (int node = 0; node < node_count; node++) {
+        offsets[node + 1] += offsets[node];
+    }
+
+    // Place every arc in its node's range, keeping their order (stable counting sort)
+    neighbors.assign(arcs.size(), 0);
+    std::vector<int> position(offsets.begin(), offsets.end() - 1);
+    for (const auto& arc : arcs) {
+        neighbors[position[arc.first]++] = arc.second;
+    }
+    viewing = false;
+    attachArcs();
+}
+
+
+
+void Graph::view(int node_count, const int* node_capacities, const int* arc_offsets_viewed,
+                 const int* arc_targets_viewed) {
+    // Only the capacities are copied, the arcs being laid out already
+    capacity.assign(node_capacities, node_capacities + node_count);
+    occupancy.assign(node_count, 0);
+    offsets.clear();
+    neighbors.clear();
+    pending_arcs.clear();
+    arc_offsets = arc_offsets_viewed;
+    arc_targets = arc_targets_viewed;
+    viewing = true;
+}
+
+
+
+int Graph::getNodeCount() const {
+    // Return the number of nodes
+    return static_cast<int>(capacity.size());
+}
+
+
+
+int Graph::getArcCount() const {
+    // Return the number of arcs laid out
+    return arc_offsets[getNodeCount()];
+}
+
+
+
+void Graph::ownArcs() {
+    // Copy the viewed arrays, which the graph can then change
+    offsets.assign(arc_offsets, arc_offsets + getNodeCount() + 1);
+    neighbors.assign(arc_targets, arc_targets + arc_offsets[getNodeCount()]);
+    viewing = false;
+    attachArcs();
+}
+
+
+
+void Graph::attachArcs() {
+    // Vectors may have moved their content, so the pointers are set again
+    arc_offsets = offsets.data();
+    arc_targets = neighbors.data();
+}
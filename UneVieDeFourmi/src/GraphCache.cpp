@@ -0,0 +1,318 @@
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include "../include/GraphCache.h"
+
+namespace {
+
+static_assert(sizeof(int) == 4, "The cache stores node indices as 32-bit integers");
+
+/** @brief Magic bytes starting a graph cache */
+const char CACHE_MAGIC[4] = {'U', 'V', 'D', 'G'};
+
+/** @brief Written in the byte order of the machine, read back only by the same order */
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+/** @brief Version of the format */
+const uint32_t FORMAT_VERSION = 2;
+
+/** @brief Number of arcs written at once */
+const size_t WRITE_CHUNK = 1 << 16;
+
+/** @brief Odd 64-bit constants of the xxHash64 rounds, also used to seed the two hash lanes */
+const uint64_t HASH_PRIME_1 = 0x9E3779B185EBCA87ULL;
+const uint64_t HASH_PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+const uint64_t HASH_PRIME_3 = 0x165667B19E3779F9ULL;
+const uint64_t HASH_PRIME_4 = 0x85EBCA77C2B2AE63ULL;
+const uint64_t HASH_PRIME_5 = 0x27D4EB2F165667C5ULL;
+
+/**
+ * @brief Fixed part at the beginning of a cache, every field naturally aligned.
+ */
+struct CacheHeader {
+    char magic[4];          ///< "UVDG".
+    uint32_t byte_order;    ///< BYTE_ORDER_MARK as written by the machine.
+    uint32_t version;       ///< FORMAT_VERSION.
+    uint32_t room_count;    ///< Room count of the "r=" line.
+    uint64_t source_size;   ///< Number of bytes of the source file hashed.
+    uint64_t hash[2];       ///< Hashes of the source file.
+    uint32_t node_count;    ///< Number of nodes.
+    uint32_t arc_count;     ///< Number of arcs.
+    uint32_t start;         ///< Index of the start node.
+    uint32_t end;           ///< Index of the end node.
+    uint64_t id_size;       ///< Number of characters of the concatenated identifiers.
+};
+
+uint64_t rotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+void hashBytes(uint64_t lanes[2], const char* begin, const char* end) {
+    // Whole words first, each one multiplied before it is mixed in so that words cannot
+    // cancel each other out, the two lanes using their own rounds
+    while (end - begin >= 8) {
+        uint64_t word;
+        std::memcpy(&word, begin, sizeof(word));
+        lanes[0] = rotateLeft(lanes[0] + word * HASH_PRIME_2, 31) * HASH_PRIME_1;
+        lanes[1] = rotateLeft(lanes[1] ^ (word * HASH_PRIME_4), 27) * HASH_PRIME_3 + HASH_PRIME_5;
+        begin += 8;
+    }
+    // Then the remaining bytes, one round each
+    for (; begin < end; begin++) {
+        uint64_t byte = static_cast<unsigned char>(*begin);
+        lanes[0] = rotateLeft(lanes[0] ^ (byte * HASH_PRIME_5), 11) * HASH_PRIME_1;
+        lanes[1] = rotateLeft(lanes[1] + byte * HASH_PRIME_3, 23) * HASH_PRIME_2;
+    }
+}
+
+uint64_t finalMix(uint64_t hash) {
+    // xxHash64 avalanche, every input bit reaching every output bit
+    hash ^= hash >> 33;
+    hash *= HASH_PRIME_2;
+    hash ^= hash >> 29;
+    hash *= HASH_PRIME_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+void writeBytes(std::FILE* file, const void* bytes, size_t length) {
+    // Report short writes, the cache would be unusable
+    if (length > 0 && std::fwrite(bytes, 1, length, file) != length) {
+        throw std::runtime_error("Could not write the graph cache");
+    }
+}
+
+} // namespace
+
+
+
+GraphCache::GraphCache(const std::string& filename)
+    : file(filename), digest(), room_count(0), node_count(0), arc_count(0), start(0), end(0),
+      capacities(nullptr), offsets(nullptr), neighbors(nullptr), id_offsets(nullptr), ids(nullptr) {
+    CacheHeader header;
+    if (file.size() < sizeof(header)) {
+        throw std::runtime_error("Invalid graph cache : truncated header");
+    }
+    std::memcpy(&header, file.begin(), sizeof(header));
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+        header.byte_order != BYTE_ORDER_MARK || header.version != FORMAT_VERSION) {
+        throw std::runtime_error("Invalid graph cache : unknown format");
+    }
+    if (header.node_count == 0 || header.node_count > INT32_MAX - 1 || header.arc_count > INT32_MAX ||
+        header.start >= header.node_count || header.end >= header.node_count) {
+        throw std::runtime_error("Invalid graph cache : inconsistent header");
+    }
+
+    // The arrays follow the header, their sizes given by the counts
+    uint64_t expected = sizeof(header) + 4 * (uint64_t(header.node_count) + header.node_count + 1 +
+                        header.arc_count + header.node_count + 1) + header.id_size;
+    if (file.size() != expected) {
+        throw std::runtime_error("Invalid graph cache : truncated arrays");
+    }
+    digest.size = header.source_size;
+    digest.hash[0] = header.hash[0];
+    digest.hash[1] = header.hash[1];
+    room_count = static_cast<int>(header.room_count);
+    node_count = static_cast<int>(header.node_count);
+    arc_count = static_cast<int>(header.arc_count);
+    start = static_cast<int>(header.start);
+    end = static_cast<int>(header.end);
+    capacities = reinterpret_cast<const int*>(file.begin() + sizeof(header));
+    offsets = capacities + node_count;
+    neighbors = offsets + node_count + 1;
+    id_offsets = reinterpret_cast<const uint32_t*>(neighbors + arc_count);
+    ids = reinterpret_cast<const char*>(id_offsets + node_count + 1);
+
+    // A corrupted cache must not send the solver out of its arrays
+    if (offsets[0] != 0 || offsets[node_count] != arc_count || id_offsets[0] != 0 ||
+        id_offsets[node_count] != header.id_size) {
+        throw std::runtime_error("Invalid graph cache : inconsistent arrays");
+    }
+    for (int node = 0; node < node_count; node++) {
+        if (offsets[node] > offsets[node + 1] || id_offsets[node] > id_offsets[node + 1]) {
+            throw std::runtime_error("Invalid graph cache : inconsistent arrays");
+        }
+    }
+    for (int arc = 0; arc < arc_count; arc++) {
+        if (static_cast<unsigned>(neighbors[arc]) >= static_cast<unsigned>(node_count)) {
+            throw std::runtime_error("Invalid graph cache : inconsistent arrays");
+        }
+    }
+}
+
+
+
+void GraphCache::write(const std::string& filename, const SourceDigest& digest, int room_count, const Graph& graph,
+                       const std::vector<std::string>& room_ids, int start, int end) {
+    int node_count = graph.getNodeCount();
+
+    // Identifier table, its offsets limited to 32 bits
+    std::vector<uint32_t> id_offsets(1, 0);
+    id_offsets.reserve(node_count + 1);
+    uint64_t id_size = 0;
+    for (const std::string& id : room_ids) {
+        id_size += id.size();
+        if (id_size > UINT32_MAX) {
+            throw std::runtime_error("Could not write the graph cache : room identifiers too long");
+        }
+        id_offsets.push_back(static_cast<uint32_t>(id_size));
+    }
+
+    CacheHeader header;
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.byte_order = BYTE_ORDER_MARK;
+    header.version = FORMAT_VERSION;
+    header.room_count = static_cast<uint32_t>(room_count);
+    header.source_size = digest.size;
+    header.hash[0] = digest.hash[0];
+    header.hash[1] = digest.hash[1];
+    header.node_count = static_cast<uint32_t>(node_count);
+    header.arc_count = static_cast<uint32_t>(graph.getArcCount());
+    header.start = static_cast<uint32_t>(start);
+    header.end = static_cast<uint32_t>(end);
+    header.id_size = id_size;
+
+    // Write a temporary file, then put it in place
+    std::string temporary = filename + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (!file) {
+        throw std::runtime_error("Could not open file " + temporary);
+    }
+    try {
+        std::vector<int> values;
+        values.reserve(node_count + 1);
+        writeBytes(file, &header, sizeof(header));
+        for (int node = 0; node < node_count; node++) {
+            values.push_back(graph.getCapacity(node));
+        }
+        writeBytes(file, values.data(), values.size() * sizeof(int));
+        values.clear();
+        for (int node = 0; node < node_count; node++) {
+            values.push_back(graph.getArcBegin(node));
+        }
+        values.push_back(graph.getArcCount());
+        writeBytes(file, values.data(), values.size() * sizeof(int));
+        values.clear();
+        for (int arc = 0; arc < graph.getArcCount(); arc++) {
+            values.push_back(graph.getArcTarget(arc));
+            if (values.size() == WRITE_CHUNK) {
+                writeBytes(file, values.data(), values.size() * sizeof(int));
+                values.clear();
+            }
+        }
+        writeBytes(file, values.data(), values.size() * sizeof(int));
+        writeBytes(file, id_offsets.data(), id_offsets.size() * sizeof(uint32_t));
+        for (const std::string& id : room_ids) {
+            writeBytes(file, id.data(), id.size());
+        }
+        if (std::fclose(file) != 0) {
+            file = nullptr;
+            throw std::runtime_error("Could not write the graph cache");
+        }
+    } catch (...) {
+        if (file) std::fclose(file);
+        std::remove(temporary.c_str());
+        throw;
+    }
+
+    // Rename does not replace an existing file everywhere
+    std::remove(filename.c_str());
+    if (std::rename(temporary.c_str(), filename.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        throw std::runtime_error("Could not write the graph cache " + filename);
+    }
+}
+
+
+
+SourceDigest GraphCache::hashAnthill(const char* begin, const char* end) {
+    // Locate the second line, left out when it gives the number of ants
+    SourceDigest digest;
+    uint64_t lanes[2] = {HASH_PRIME_5, HASH_PRIME_1 ^ HASH_PRIME_4};
+    const char* ants = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+    if (ants && end - ants > 2 && ants[1] == 'f' && ants[2] == '=') {
+        const char* ants_end = static_cast<const char*>(std::memchr(ants + 1, '\n', end - ants - 1));
+        if (!ants_end) ants_end = end;
+        hashBytes(lanes, begin, ants + 1);
+        hashBytes(lanes, ants_end, end);
+        digest.size = static_cast<uint64_t>((ants + 1 - begin) + (end - ants_end));
+    } else {
+        hashBytes(lanes, begin, end);
+        digest.size = static_cast<uint64_t>(end - begin);
+    }
+
+    // The size is mixed in as well, then each lane is finalized
+    digest.hash[0] = finalMix(lanes[0] + digest.size);
+    digest.hash[1] = finalMix(lanes[1] ^ rotateLeft(digest.size, 32));
+    return digest;
+}
+
+
+
+const SourceDigest& GraphCache::getDigest() const {
+    // Return the digest of the source file
+    return digest;
+}
+
+
+
+int GraphCache::getRoomCount() const {
+    // Return the room count of the "r=" line
+    return room_count;
+}
+
+
+
+int GraphCache::getNodeCount() const {
+    // Return the number of nodes
+    return node_count;
+}
+
+
+
+int GraphCache::getArcCount() const {
+    // Return the number of arcs
+    return arc_count;
+}
+
+
+
+int GraphCache::getStart() const {
+    // Return the start node
+    return start;
+}
+
+
+
+int GraphCache::getEnd() const {
+    // Return the end node
+    return end;
+}
+
+
+
+const int* GraphCache::getCapacities() const {
+    // Return the capacities, in the mapping
+    return capacities;
+}
+
+
+
+const int* GraphCache::getOffsets() const {
+    // Return the CSR offsets, in the mapping
+    return offsets;
+}
+
+
+
+const int* GraphCache::getNeighbors() const {
+    // Return the CSR neighbors, in the mapping
+    return neighbors;
+}
+
+
+
+std::string GraphCache::getRoomId(int node) const {
+    // Copy the identifier out of the table
+    return std::string(ids + id_offsets[node], id_offsets[node + 1] - id_offsets[node]);
+}
@@ -0,0 +1,220 @@
+#include <algorithm>
+#include "../include/GraphReduction.h"
+
+ReducedGraph::ReducedGraph(const Graph& graph, int start, int end)
+    : original(graph), original_source(start), original_target(end), source(-1), target(-1) {
+    int room_count = original.getNodeCount();
+    std::vector<bool> useful = findUsefulRooms();
+
+    // Count the useful neighbors of each useful room
+    std::vector<int> degree(room_count, 0);
+    for (int room = 0; room < room_count; room++) {
+        if (!useful[room]) continue;
+        for (int arc = original.getArcBegin(room); arc < original.getArcEnd(room); arc++) {
+            if (useful[original.getArcTarget(arc)]) degree[room]++;
+        }
+    }
+
+    // A corridor room has two different useful neighbors; the start and end rooms are kept
+    auto isCorridor = [&](int room) {
+        if (!useful[room] || room == original_source || room == original_target || degree[room] != 2) return false;
+        int first = -1;
+        for (int arc = original.getArcBegin(room); arc < original.getArcEnd(room); arc++) {
+            int next = original.getArcTarget(arc);
+            if (!useful[next]) continue;
+            if (first >= 0) return next != first;
+            first = next;
+        }
+        return false;
+    };
+
+    // Every other useful room keeps its own node
+    std::vector<int> node(room_count, -1);
+    for (int room = 0; room < room_count; room++) {
+        if (useful[room] && !isCorridor(room)) {
+            node[room] = reduced.addNode(original.getCapacity(room));
+            rooms.push_back(std::vector<int>(1, room));
+            entrance.push_back(-1);
+        }
+    }
+    source = node[original_source];
+    target = node[original_target];
+
+    // Walk each corridor from the room before it to the room after it
+    std::vector<int> exit_node;
+    for (int room = 0; room < room_count; room++) {
+        if (node[room] < 0 || isCorridor(room)) continue;
+        for (int arc = original.getArcBegin(room); arc < original.getArcEnd(room); arc++) {
+            int next = original.getArcTarget(arc);
+            if (!isCorridor(next) || node[next] >= 0) continue;
+
+            std::vector<int> corridor;
+            int capacity = original.getCapacity(next);
+            int previous = room;
+            int current = next;
+            while (isCorridor(current)) {
+                corridor.push_back(current);
+                capacity = std::min(capacity, original.getCapacity(current));
+                int following = -1;
+                for (int a = original.getArcBegin(current); a < original.getArcEnd(current); a++) {
+                    int candidate = original.getArcTarget(a);
+                    if (useful[candidate] && candidate != previous) following = candidate;
+                }
+                previous = current;
+                current = following;
+            }
+
+            int corridor_node = reduced.addNode(capacity);
+            for (int member : corridor) {
+                node[member] = corridor_node;
+            }
+            rooms.push_back(std::move(corridor));
+            entrance.push_back(node[room]);
+            exit_node.resize(corridor_node + 1, -1);
+            exit_node[corridor_node] = node[current];
+        }
+    }
+    exit_node.resize(reduced.getNodeCount(), -1);
+
+    // Tunnels of the remaining rooms keep their order; a corridor leads to both its ends
+    for (int room = 0; room < room_count; room++) {
+        if (!useful[room] || isCorridor(room)) continue;
+        for (int arc = original.getArcBegin(room); arc < original.getArcEnd(room); arc++) {
+            int next = original.getArcTarget(arc);
+            if (useful[next]) reduced.addEdge(node[room], node[next]);
+        }
+    }
+    for (int corridor_node = 0; corridor_node < reduced.getNodeCount(); corridor_node++) {
+        if (entrance[corridor_node] < 0) continue;
+        reduced.addEdge(corridor_node, entrance[corridor_node]);
+        reduced.addEdge(corridor_node, exit_node[corridor_node]);
+    }
+    reduced.build();
+}
+
+
+
+std::vector<bool> ReducedGraph::findUsefulRooms() const {
+    int room_count = original.getNodeCount();
+    std::vector<bool> useful(room_count, false);
+    if (original_source == original_target) {
+        useful[original_source] = true;
+        return useful;
+    }
+
+    // Iterative Tarjan search of biconnected blocks from the start room. The virtual
+    // tunnel to the end room is followed first, so the block holding it is the last
+    // one closed below the end room
+    struct Frame {
+        int room;             ///< Room explored.
+        int parent;           ///< Room it was reached from, -1 for the start room.
+        int next_arc;         ///< Next arc to follow, -1 before the virtual tunnel.
+        bool parent_skipped;  ///< Whether the tunnel back to the parent was skipped.
+    };
+    std::vector<int> discovery(room_count, -1);
+    std::vector<int> low(room_count, 0);
+    std::vector<Frame> frames;
+    std::vector<int> pending;
+    int time = 0;
+
+    discovery[original_source] = low[original_source] = time++;
+    frames.push_back({original_source, -1, -1, false});
+    pending.push_back(original_source);
+
+    while (!frames.empty()) {
+        Frame& frame = frames.back();
+        int room = frame.room;
+        int next;
+
+        if (frame.next_arc < 0) {
+            // Only the start and end rooms have the virtual tunnel
+            frame.next_arc = original.getArcBegin(room);
+            if (room != original_source && room != original_target) continue;
+            next = room == original_source ? original_target : original_source;
+        } else if (frame.next_arc < original.getArcEnd(room)) {
+            next = original.getArcTarget(frame.next_arc++);
+        } else {
+            // Every tunnel was followed: close the blocks hanging below the room
+            frames.pop_back();
+            if (frames.empty()) break;
+            int parent = frames.back().room;
+            low[parent] = std::min(low[parent], low[room]);
+            if (low[room] >= discovery[parent]) {
+                bool holds_virtual = parent == original_source && room == original_target;
+                int member;
+                do {
+                    member = pending.back();
+                    pending.pop_back();
+                    if (holds_virtual) useful[member] = true;
+                } while (member != room);
+                if (holds_virtual) useful[parent] = true;
+            }
+            continue;
+        }
+
+        // The tunnel used to reach the room is not a way back up
+        if (next == frame.parent && !frame.parent_skipped) {
+            frame.parent_skipped = true;
+            continue;
+        }
+
+        if (discovery[next] < 0) {
+            discovery[next] = low[next] = time++;
+            pending.push_back(next);
+            frames.push_back({next, room, -1, false});
+        } else {
+            low[room] = std::min(low[room], discovery[next]);
+        }
+    }
+
+    return useful;
+}
+
+
+
+const Graph& ReducedGraph::getGraph() const {
+    // Return the graph to search
+    return reduced;
+}
+
+
+
+int ReducedGraph::getSource() const {
+    // Return the node of the start room
+    return source;
+}
+
+
+
+int ReducedGraph::getTarget() const {
+    // Return the node of the end room
+    return target;
+}
+
+
+
+int ReducedGraph::getRoomCount(int node) const {
+    // Return the number of rooms crossed when going through the node
+    return static_cast<int>(rooms[node].size());
+}
+
+
+
+void ReducedGraph::expand(const PathBuffer& paths, PathBuffer& expanded) const {
+    expanded.clear();
+    for (size_t i = 0; i < paths.size(); i++) {
+        for (size_t k = paths.begins[i]; k < paths.begins[i + 1]; k++) {
+            int current = paths.rooms[k];
+            const std::vector<int>& members = rooms[current];
+
+            // A corridor is crossed forwards when entered from its entrance
+            if (entrance[current] < 0 || paths.rooms[k - 1] == entrance[current]) {
+                expanded.rooms.insert(expanded.rooms.end(), members.begin(), members.end());
+            } else {
+                expanded.rooms.insert(expanded.rooms.end(), members.rbegin(), members.rend());
+            }
+        }
+        expanded.begins.push_back(expanded.rooms.size());
+        expanded.bottlenecks.push_back(paths.bottlenecks[i]);
+    }
+}
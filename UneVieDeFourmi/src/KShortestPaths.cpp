@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <climits>
+#include "../include/KShortestPaths.h"
+
+KShortestPaths::KShortestPaths(const Graph& graph, int source, int target)
+    : graph(graph), source(source), target(target), max_length(INT_MAX), started(false),
+      pending_deviations(false), deadline(nullptr), interrupted(false), banned(graph.getNodeCount(), 0), seen(graph.getNodeCount(), 0),
+      parent(graph.getNodeCount(), -1), root_stamp(0), search_stamp(0) {
+    // Collect the distinct room capacities, from the lowest to the highest
+    for (int room = 0; room < graph.getNodeCount(); room++) {
+        tiers.push_back(graph.getCapacity(room));
+    }
+    std::sort(tiers.begin(), tiers.end());
+    tiers.erase(std::unique(tiers.begin(), tiers.end()), tiers.end());
+}
+
+
+
+bool KShortestPaths::next(std::vector<int>& rooms, int& bottleneck) {
+    // Seed Yen's heap with the best path
+    if (!started) {
+        started = true;
+        Candidate first;
+        if (deviate(std::vector<int>(1, source), 0, first)) {
+            known.insert(first.rooms);
+            candidates.push(first);
+        }
+    }
+
+    while (true) {
+        // Deviations of the path returned last time are only computed when needed
+        if (pending_deviations) {
+            addDeviations();
+            pending_deviations = false;
+        }
+        if (interrupted || candidates.empty()) return false;
+
+        Candidate best = candidates.top();
+        candidates.pop();
+
+        // Queued before the limit was lowered: its root may still lead to a path that fits
+        if (best.rooms.size() - 1 > static_cast<size_t>(max_length)) {
+            if (expired()) return false;
+            Candidate replacement;
+            if (deviate(best.rooms, best.spur, replacement) && known.insert(replacement.rooms).second) {
+                candidates.push(replacement);
+            }
+            continue;
+        }
+
+        // Record the path in the prefix tree, which gives the arcs banned after each root
+        if (prefixes.empty()) prefixes.emplace_back();
+        int node = 0;
+        for (size_t i = 1; i < best.rooms.size(); i++) {
+            auto& next = prefixes[node].next;
+            auto child = std::find_if(next.begin(), next.end(),
+                                      [&](const std::pair<int, int>& entry) { return entry.first == best.rooms[i]; });
+            if (child != next.end()) {
+                node = child->second;
+                continue;
+            }
+            next.emplace_back(best.rooms[i], static_cast<int>(prefixes.size()));
+            node = static_cast<int>(prefixes.size());
+            prefixes.emplace_back();
+        }
+        last = best.rooms;
+        pending_deviations = true;
+        rooms = best.rooms;
+        bottleneck = best.bottleneck;
+        return true;
+    }
+}
+
+
+
+void KShortestPaths::limitLength(int max_length) {
+    // Only ever lowered, queued candidates being checked when they come out
+    this->max_length = std::min(this->max_length, max_length);
+}
+
+
+
+void KShortestPaths::setDeadline(const Deadline* deadline) {
+    // The spur searches stop once this deadline expires
+    this->deadline = deadline;
+}
+
+
+
+bool KShortestPaths::wasInterrupted() const {
+    // Return whether the deadline stopped the generator
+    return interrupted;
+}
+
+
+
+bool KShortestPaths::deviate(const std::vector<int>& path, size_t spur, Candidate& candidate) {
+    const int from = path[spur];
+    const long long remaining = static_cast<long long>(max_length) - static_cast<long long>(spur);
+    if (remaining < 1) return false;
+
+    // The rooms before the spur room cannot be used again
+    root_stamp++;
+    int root_capacity = graph.getCapacity(from);
+    for (size_t j = 0; j < spur; j++) {
+        banned[path[j]] = root_stamp;
+        root_capacity = std::min(root_capacity, graph.getCapacity(path[j]));
+    }
+
+    // Arcs already used after the same root by an accepted path are removed
+    banned_next.clear();
+    int node = prefixes.empty() ? -1 : 0;
+    for (size_t j = 1; j <= spur && node != -1; j++) {
+        const auto& next = prefixes[node].next;
+        auto child = std::find_if(next.begin(), next.end(),
+                                  [&](const std::pair<int, int>& entry) { return entry.first == path[j]; });
+        node = child != next.end() ? child->second : -1;
+    }
+    if (node != -1) {
+        for (const auto& entry : prefixes[node].next) {
+            banned_next.push_back(entry.first);
+        }
+    }
+
+    // Completions within the limit exist for every threshold up to some capacity:
+    // find the highest one, no higher than the root, starting with the root itself
+    std::vector<int> spur_path;
+    auto fits = [&](size_t tier) {
+        return shortestPath(from, tiers[tier], spur_path) &&
+               static_cast<long long>(spur_path.size()) - 1 <= remaining;
+    };
+    size_t high = std::upper_bound(tiers.begin(), tiers.end(), root_capacity) - tiers.begin();
+    if (high == 0) return false;
+    size_t best = high - 1;
+    if (!fits(best)) {
+        if (best == 0 || !fits(0)) return false;
+
+        // Binary search between a threshold that fits (low) and one that does not (best)
+        size_t low = 0;
+        while (best - low > 1) {
+            size_t middle = low + (best - low) / 2;
+            if (fits(middle)) {
+                low = middle;
+            } else {
+                best = middle;
+            }
+        }
+        best = low;
+        fits(best);
+    }
+
+    // Join the root with the shortest spur path of the threshold found
+    candidate.rooms.assign(path.begin(), path.begin() + spur);
+    candidate.rooms.insert(candidate.rooms.end(), spur_path.begin(), spur_path.end());
+    candidate.bottleneck = graph.getCapacity(candidate.rooms[0]);
+    for (int room : candidate.rooms) {
+        candidate.bottleneck = std::min(candidate.bottleneck, graph.getCapacity(room));
+    }
+    candidate.spur = spur;
+    return true;
+}
+
+
+
+bool KShortestPaths::shortestPath(int from, int minimum, std::vector<int>& path) {
+    path.clear();
+    if (graph.getCapacity(from) < minimum || banned[from] == root_stamp) return false;
+
+    // Breadth-first search on the rooms of the threshold that are not banned
+    search_stamp++;
+    std::vector<int> queue;
+    queue.push_back(from);
+    seen[from] = search_stamp;
+    parent[from] = -1;
+    for (size_t head = 0; head < queue.size() && seen[target] != search_stamp; head++) {
+        int room = queue[head];
+        for (int arc = graph.getArcBegin(room); arc < graph.getArcEnd(room); arc++) {
+            int next = graph.getArcTarget(arc);
+            if (seen[next] == search_stamp || banned[next] == root_stamp || graph.getCapacity(next) < minimum) {
+                continue;
+            }
+            if (room == from && std::find(banned_next.begin(), banned_next.end(), next) != banned_next.end()) continue;
+            seen[next] = search_stamp;
+            parent[next] = room;
+            queue.push_back(next);
+        }
+    }
+    if (seen[target] != search_stamp) return false;
+
+    // Rebuild the path from the target
+    for (int room = target; room != -1; room = parent[room]) {
+        path.push_back(room);
+    }
+    std::reverse(path.begin(), path.end());
+    return true;
+}
+
+
+
+void KShortestPaths::addDeviations() {
+    // Each room of the last path (except the target) is a spur room
+    for (size_t i = 0; i + 1 < last.size(); i++) {
+        if (expired()) return;
+        Candidate candidate;
+        if (deviate(last, i, candidate) && known.insert(candidate.rooms).second) {
+            candidates.push(candidate);
+        }
+    }
+}
+
+
+
+bool KShortestPaths::expired() {
+    // Once expired, the generator stays interrupted
+    if (!interrupted && deadline && deadline->hasExpired()) {
+        interrupted = true;
+    }
+    return interrupted;
+}
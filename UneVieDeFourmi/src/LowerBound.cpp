@@ -0,0 +1,64 @@
+#include <queue>
+#include <vector>
+#include "../include/LowerBound.h"
+
+LowerBound::LowerBound(const Graph& graph, int source, int sink, int ant_count)
+    : LowerBound(graph, source, sink, ant_count, RoomFlow(graph, source, sink, ant_count)) {}
+
+
+
+LowerBound::LowerBound(const Graph& graph, int source, int sink, int ant_count, const RoomFlow& flow)
+    : minimum_cut(0), shortest_length(-1), steps(-1) {
+    int rooms = graph.getNodeCount();
+
+    // Fewest tunnels from the start room to the end room
+    std::vector<int> distance(rooms, -1);
+    std::queue<int> queue;
+    distance[source] = 0;
+    queue.push(source);
+    while (!queue.empty() && distance[sink] < 0) {
+        int room = queue.front();
+        queue.pop();
+        for (int arc = graph.getArcBegin(room); arc < graph.getArcEnd(room); arc++) {
+            int next = graph.getArcTarget(arc);
+            if (distance[next] < 0) {
+                distance[next] = distance[room] + 1;
+                queue.push(next);
+            }
+        }
+    }
+    shortest_length = distance[sink];
+    if (shortest_length < 0) return;
+    if (ant_count == 0) {
+        steps = 0;
+        return;
+    }
+
+    // Smallest cut of rooms, as a maximum flow, unless the flow was cut short
+    if (flow.wasInterrupted()) return;
+    minimum_cut = flow.getValue();
+    if (minimum_cut <= 0) return;
+
+    steps = static_cast<int>((ant_count + minimum_cut - 1) / minimum_cut) + shortest_length - 1;
+}
+
+
+
+long long LowerBound::getMinimumCut() const {
+    // Return the maximum flow found
+    return minimum_cut;
+}
+
+
+
+int LowerBound::getShortestLength() const {
+    // Return the distance found by the breadth-first search
+    return shortest_length;
+}
+
+
+
+int LowerBound::getSteps() const {
+    // Return the combined bound
+    return steps;
+}
@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <numeric>
+#include "../include/Makespan.h"
+
+int computeMakespan(const std::vector<Path>& paths, size_t path_count, int ant_count,
+                    std::vector<int>& quotas) {
+    quotas.assign(path_count, 0);
+    if (ant_count == 0) return 0;
+
+    // Fill the shortest paths first
+    std::vector<size_t> order(path_count);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&paths](size_t a, size_t b) {
+        return paths[a].path.size() < paths[b].path.size();
+    });
+
+    // With the k shortest paths in use, T steps bring sum(c * (T - L + 1)) ants:
+    // solve for T, and stop once T is shorter than the next path
+    long long capacity = 0;
+    long long delay = 0;
+    long long makespan = -1;
+    size_t used = 0;
+    for (size_t k = 0; k < path_count; k++) {
+        const Path& path = paths[order[k]];
+        if (path.capacityMinimum <= 0) continue;
+
+        long long length = static_cast<long long>(path.path.size()) - 1;
+        capacity += path.capacityMinimum;
+        delay += path.capacityMinimum * (length - 1);
+        makespan = std::max(length, (ant_count + delay + capacity - 1) / capacity);
+        used = k + 1;
+
+        if (k + 1 < path_count && makespan < static_cast<long long>(paths[order[k + 1]].path.size()) - 1) {
+            break;
+        }
+    }
+    if (makespan < 0) return -1;
+
+    // Every path in use is filled up to the makespan...
+    long long excess = -ant_count;
+    for (size_t k = 0; k < used; k++) {
+        const Path& path = paths[order[k]];
+        if (path.capacityMinimum <= 0) continue;
+
+        long long length = static_cast<long long>(path.path.size()) - 1;
+        long long quota = std::min<long long>(path.capacityMinimum * (makespan - length + 1), ant_count);
+        quotas[order[k]] = static_cast<int>(quota);
+        excess += quota;
+    }
+
+    // ...then the ants in excess are taken back from the longest ones
+    for (size_t k = used; k-- > 0 && excess > 0;) {
+        int removed = static_cast<int>(std::min<long long>(excess, quotas[order[k]]));
+        quotas[order[k]] -= removed;
+        excess -= removed;
+    }
+
+    return static_cast<int>(makespan);
+}
+
+
+
+MakespanEvaluator::MakespanEvaluator(int ant_count)
+    : ant_count(ant_count), capacity(0), delay(0), makespan(-1) {}
+
+
+
+int MakespanEvaluator::addPath(const Path& path) {
+    if (ant_count == 0) return 0;
+
+    // A path that cannot carry ants, or not before the current makespan, changes nothing
+    long long length = static_cast<long long>(path.path.size()) - 1;
+    if (path.capacityMinimum <= 0 || (makespan >= 0 && length > makespan)) {
+        return static_cast<int>(makespan);
+    }
+
+    capacity += path.capacityMinimum;
+    delay += path.capacityMinimum * (length - 1);
+    used.push(std::make_pair(length, path.capacityMinimum));
+    makespan = (ant_count + delay + capacity - 1) / capacity;
+
+    // Drop the longest paths while they are too long to bring an ant in time
+    while (used.top().first > makespan) {
+        capacity -= used.top().second;
+        delay -= used.top().second * (used.top().first - 1);
+        used.pop();
+        makespan = (ant_count + delay + capacity - 1) / capacity;
+    }
+
+    return static_cast<int>(makespan);
+}
+
+
+
+int MakespanEvaluator::getMakespan() const {
+    // Without ants there is nothing to wait for
+    return ant_count == 0 ? 0 : static_cast<int>(makespan);
+}
@@ -0,0 +1,113 @@
+#include <stdexcept>
+#include "../include/MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& filename)
+    : data(nullptr), length(0), file_handle(INVALID_HANDLE_VALUE), mapping_handle(nullptr) {
+    // Open the file for reading
+    file_handle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file_handle == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Could not open file " + filename);
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file_handle, &file_size)) {
+        CloseHandle(file_handle);
+        throw std::runtime_error("Could not read size of file " + filename);
+    }
+    length = static_cast<size_t>(file_size.QuadPart);
+
+    // An empty file cannot be mapped: expose an empty range instead
+    if (length == 0) return;
+
+    mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_handle) {
+        data = static_cast<const char*>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (!data) {
+        if (mapping_handle) CloseHandle(mapping_handle);
+        CloseHandle(file_handle);
+        throw std::runtime_error("Could not map file " + filename);
+    }
+}
+
+
+
+MappedFile::~MappedFile() {
+    // Release the view, the mapping and the file
+    if (data) UnmapViewOfFile(data);
+    if (mapping_handle) CloseHandle(mapping_handle);
+    if (file_handle != INVALID_HANDLE_VALUE) CloseHandle(file_handle);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& filename) : data(nullptr), length(0), descriptor(-1) {
+    // Open the file for reading
+    descriptor = open(filename.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        throw std::runtime_error("Could not open file " + filename);
+    }
+
+    struct stat status;
+    if (fstat(descriptor, &status) != 0) {
+        close(descriptor);
+        throw std::runtime_error("Could not read size of file " + filename);
+    }
+    length = static_cast<size_t>(status.st_size);
+
+    // An empty file cannot be mapped: expose an empty range instead
+    if (length == 0) return;
+
+    void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (mapping == MAP_FAILED) {
+        close(descriptor);
+        throw std::runtime_error("Could not map file " + filename);
+    }
+    data = static_cast<const char*>(mapping);
+
+    // The file is read once from start to end
+    madvise(mapping, length, MADV_SEQUENTIAL);
+}
+
+
+
+MappedFile::~MappedFile() {
+    // Release the mapping and the file
+    if (data) munmap(const_cast<char*>(data), length);
+    if (descriptor >= 0) close(descriptor);
+}
+
+#endif
+
+
+
+const char* MappedFile::begin() const {
+    // Return the beginning of the mapped content
+    return data;
+}
+
+
+
+const char* MappedFile::end() const {
+    // Return the end of the mapped content
+    return data + length;
+}
+
+
+
+size_t MappedFile::size() const {
+    // Return the number of bytes mapped
+    return length;
+}
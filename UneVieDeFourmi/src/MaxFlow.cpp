@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include "../include/MaxFlow.h"
+
+const long long MaxFlow::INFINITE_CAPACITY = std::numeric_limits<long long>::max() / 4;
+
+
+
+MaxFlow::MaxFlow(int node_count)
+    : node_count(node_count), adjacency(node_count), level(node_count), next_edge(node_count),
+      deadline(nullptr), interrupted(false) {}
+
+
+
+int MaxFlow::addEdge(int from, int to, long long capacity) {
+    // Store the forward edge followed by its reverse residual edge
+    int id = static_cast<int>(edges.size());
+    edges.push_back({to, capacity, 0});
+    edges.push_back({from, 0, 0});
+    adjacency[from].push_back(id);
+    adjacency[to].push_back(id + 1);
+    return id;
+}
+
+
+
+bool MaxFlow::buildLevels(int source, int sink) {
+    // Breadth-first search on edges that still have residual capacity
+    std::fill(level.begin(), level.end(), -1);
+    std::queue<int> queue;
+    level[source] = 0;
+    queue.push(source);
+
+    while (!queue.empty()) {
+        int node = queue.front();
+        queue.pop();
+        for (int id : adjacency[node]) {
+            const Edge& edge = edges[id];
+            if (edge.capacity > 0 && level[edge.to] < 0) {
+                level[edge.to] = level[node] + 1;
+                queue.push(edge.to);
+            }
+        }
+    }
+    return level[sink] >= 0;
+}
+
+
+
+long long MaxFlow::run(int source, int sink, long long limit) {
+    long long total = 0;
+    interrupted = false;
+    if (source == sink) return total;
+
+    std::vector<int> path;
+
+    // Each phase saturates a blocking flow of the level graph, unless the deadline expired
+    while (total < limit && buildLevels(source, sink)) {
+        if (deadline && deadline->hasExpired()) {
+            interrupted = true;
+            break;
+        }
+        std::fill(next_edge.begin(), next_edge.end(), 0);
+
+        while (total < limit) {
+            // Walk down the level graph with an explicit stack of edges
+            path.clear();
+            int node = source;
+            while (node != sink) {
+                bool advanced = false;
+                while (next_edge[node] < adjacency[node].size()) {
+                    int id = adjacency[node][next_edge[node]];
+                    const Edge& edge = edges[id];
+                    if (edge.capacity > 0 && level[edge.to] == level[node] + 1) {
+                        path.push_back(id);
+                        node = edge.to;
+                        advanced = true;
+                        break;
+                    }
+                    next_edge[node]++;
+                }
+
+                if (!advanced) {
+                    // Dead end: remove the node from this phase and backtrack
+                    level[node] = -1;
+                    if (path.empty()) break;
+                    node = edges[path.back() ^ 1].to;
+                    path.pop_back();
+                    next_edge[node]++;
+                }
+            }
+            if (node != sink) break;
+
+            // Push the bottleneck amount along the path found
+            long long pushed = limit - total;
+            for (int id : path) {
+                pushed = std::min(pushed, edges[id].capacity);
+            }
+            for (int id : path) {
+                edges[id].capacity -= pushed;
+                edges[id].flow += pushed;
+                edges[id ^ 1].capacity += pushed;
+                edges[id ^ 1].flow -= pushed;
+            }
+            total += pushed;
+        }
+    }
+    return total;
+}
+
+
+
+void MaxFlow::setDeadline(const Deadline* deadline) {
+    // The computation stops once this deadline expires
+    this->deadline = deadline;
+}
+
+
+
+bool MaxFlow::wasInterrupted() const {
+    // Return whether the deadline cut the last computation short
+    return interrupted;
+}
+
+
+
+long long MaxFlow::getFlow(int edge) const {
+    // Return the flow carried by the forward edge
+    return edges[edge].flow;
+}
+
+
+
+int MaxFlow::getNodeCount() const {
+    // Return the number of nodes in the network
+    return node_count;
+}
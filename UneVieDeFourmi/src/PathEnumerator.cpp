@@ -0,0 +1,258 @@
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <queue>
+#include <utility>
+#include "../include/PathEnumerator.h"
+
+const size_t PathEnumerator::DEFAULT_MAXIMUM_ROOMS = size_t(1) << 23;
+
+
+
+PathEnumerator::PathEnumerator(const Graph& graph, int source, int target, const std::vector<int>& lengths)
+    : graph(graph), source(source), target(target), lengths(lengths),
+      to_target(graph.getNodeCount(), -1), max_length(INT_MAX), max_rooms(DEFAULT_MAXIMUM_ROOMS),
+      room_count(0), deadline(nullptr), interrupted(false), truncated(false) {
+    if (this->lengths.empty()) {
+        this->lengths.assign(graph.getNodeCount(), 1);
+    }
+
+    // Reverse search from the target (tunnels go both ways): entering a room costs its length
+    typedef std::pair<int, int> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    to_target[target] = 0;
+    queue.push(Entry(0, target));
+    while (!queue.empty()) {
+        Entry entry = queue.top();
+        queue.pop();
+        int room = entry.second;
+        if (entry.first > to_target[room]) continue;
+
+        int distance = entry.first + this->lengths[room];
+        for (int arc = graph.getArcBegin(room); arc < graph.getArcEnd(room); arc++) {
+            int previous = graph.getArcTarget(arc);
+            if (to_target[previous] < 0 || distance < to_target[previous]) {
+                to_target[previous] = distance;
+                queue.push(Entry(distance, previous));
+            }
+        }
+    }
+}
+
+
+
+int PathEnumerator::getShortestLength() const {
+    // Return the distance from the source found by the reverse search
+    return to_target[source];
+}
+
+
+
+void PathEnumerator::limitLength(int length) {
+    // Paths longer than this are not produced
+    max_length = length;
+}
+
+
+
+void PathEnumerator::limitRooms(size_t rooms) {
+    // The search stops before the paths found hold more rooms than this
+    max_rooms = rooms;
+}
+
+
+
+void PathEnumerator::setDeadline(const Deadline* deadline) {
+    // The search stops once this deadline expires
+    this->deadline = deadline;
+}
+
+
+
+bool PathEnumerator::wasInterrupted() const {
+    // Return whether the deadline cut the last search short
+    return interrupted;
+}
+
+
+
+bool PathEnumerator::wasTruncated() const {
+    // Return whether the room limit cut the last search short
+    return truncated;
+}
+
+
+
+bool PathEnumerator::canExtend(const Scratch& scratch, const Frame& frame, int next) const {
+    // The path must still be able to reach the target in time
+    if (to_target[next] < 0 || static_cast<long long>(frame.length) + lengths[next] + to_target[next] > max_length) {
+        return false;
+    }
+
+    // A tunnel from the next room to an earlier room of the path would be a shortcut
+    for (int arc = graph.getArcBegin(next); arc < graph.getArcEnd(next); arc++) {
+        int room = graph.getArcTarget(arc);
+        if (room != frame.room && isVisited(scratch, room)) return false;
+    }
+    return true;
+}
+
+
+
+void PathEnumerator::enumerate(PathBuffer& output) {
+    // A path from a room to itself only contains that room
+    if (source == target) {
+        output.rooms.push_back(source);
+        output.begins.push_back(output.rooms.size());
+        output.bottlenecks.push_back(graph.getCapacity(source));
+        return;
+    }
+
+    // A single task covers the whole search
+    interrupted = false;
+    truncated = false;
+    room_count = 0;
+    scratches.resize(1);
+    scratches[0].visited.assign((graph.getNodeCount() + 63) / 64, 0);
+    Task task;
+    task.root = {source, graph.getArcBegin(source), graph.getArcEnd(source), graph.getCapacity(source), lengths[source] - 1};
+    explore(task, output, scratches[0], nullptr);
+}
+
+
+
+void PathEnumerator::enumerate(ThreadPool& pool, PathBuffer& output) {
+    if (source == target) {
+        enumerate(output);
+        return;
+    }
+
+    // Every worker gets its own visited bitset and stack
+    scratches.resize(pool.getThreadCount());
+    for (Scratch& scratch : scratches) {
+        scratch.visited.assign((graph.getNodeCount() + 63) / 64, 0);
+    }
+
+    // Start with the whole search; workers split it while they explore it
+    interrupted = false;
+    truncated = false;
+    room_count = 0;
+    tasks.clear();
+    std::unique_ptr<Task> root(new Task());
+    root->root = {source, graph.getArcBegin(source), graph.getArcEnd(source), graph.getCapacity(source), lengths[source] - 1};
+    root->route.push_back(graph.getArcBegin(source));
+    schedule(std::move(root), pool);
+    pool.wait();
+
+    // Merge the pieces in the order of the arcs leading to them (sequential search order)
+    std::sort(tasks.begin(), tasks.end(),
+        [](const std::unique_ptr<Task>& a, const std::unique_ptr<Task>& b) {
+            return a->route < b->route;
+        });
+    for (const auto& task : tasks) {
+        output.append(task->output);
+    }
+    tasks.clear();
+}
+
+
+
+void PathEnumerator::schedule(std::unique_ptr<Task> task, ThreadPool& pool) {
+    Task* work = task.get();
+    {
+        std::lock_guard<std::mutex> lock(tasks_mutex);
+        tasks.push_back(std::move(task));
+    }
+    pool.submit([this, work, &pool] {
+        explore(*work, work->output, scratches[ThreadPool::getWorkerIndex()], &pool);
+    });
+}
+
+
+
+void PathEnumerator::explore(Task& task, PathBuffer& output, Scratch& scratch, ThreadPool* pool) {
+    std::vector<Frame>& stack = scratch.stack;
+
+    // The rooms leading to the subtree cannot be used again
+    for (int room : task.prefix) {
+        setVisited(scratch, room);
+    }
+    stack.clear();
+    stack.push_back(task.root);
+    setVisited(scratch, task.root.room);
+
+    unsigned iterations = 0;
+    while (!stack.empty()) {
+        // Give up the subtree once the deadline expired or the room limit was reached,
+        // here or on another worker
+        if ((++iterations & 1023) == 0 && (truncated || (deadline && (interrupted || deadline->hasExpired())))) {
+            if (!truncated) interrupted = true;
+            for (const Frame& room : stack) {
+                clearVisited(scratch, room.room);
+            }
+            stack.clear();
+            break;
+        }
+
+        // Hand the untried arcs of the shallowest room over to an idle worker
+        if (pool && (iterations & 63) == 0 && pool->isStarving()) {
+            for (size_t depth = 0; depth < stack.size(); depth++) {
+                Frame& frame = stack[depth];
+                if (frame.next_arc == frame.arc_end) continue;
+
+                std::unique_ptr<Task> split(new Task());
+                split->prefix = task.prefix;
+                split->route.assign(task.route.begin(), task.route.end() - 1);
+                for (size_t i = 0; i < depth; i++) {
+                    split->prefix.push_back(stack[i].room);
+                    split->route.push_back(stack[i].next_arc - 1);
+                }
+                split->route.push_back(frame.next_arc);
+                split->root = frame;
+                frame.arc_end = frame.next_arc;
+                schedule(std::move(split), *pool);
+                break;
+            }
+        }
+
+        Frame& frame = stack.back();
+
+        // Every arc of the room was followed: go back to the previous room
+        if (frame.next_arc == frame.arc_end) {
+            clearVisited(scratch, frame.room);
+            stack.pop_back();
+            continue;
+        }
+
+        int next = graph.getArcTarget(frame.next_arc++);
+        if (isVisited(scratch, next) || !canExtend(scratch, frame, next)) continue;
+
+        int bottleneck = std::min(frame.bottleneck, graph.getCapacity(next));
+        if (next == target) {
+            // The target ends the path: store it without exploring further, unless it
+            // would take the paths over the room limit
+            size_t path_rooms = static_cast<size_t>(frame.length) + lengths[next] + 1;
+            if (truncated || room_count.fetch_add(path_rooms) + path_rooms > max_rooms) {
+                truncated = true;
+                continue;
+            }
+            output.rooms.insert(output.rooms.end(), task.prefix.begin(), task.prefix.end());
+            for (const Frame& room : stack) {
+                output.rooms.push_back(room.room);
+            }
+            output.rooms.push_back(next);
+            output.begins.push_back(output.rooms.size());
+            output.bottlenecks.push_back(bottleneck);
+        } else {
+            // Extend the current path with the next room
+            setVisited(scratch, next);
+            stack.push_back({next, graph.getArcBegin(next), graph.getArcEnd(next), bottleneck,
+                             frame.length + lengths[next]});
+        }
+    }
+
+    // Leave the bitset clean for the next task
+    for (int room : task.prefix) {
+        clearVisited(scratch, room);
+    }
+}
@@ -1,10 +1,11 @@
 
+#include <algorithm>
 #include "../include/Room.h"
 #include "../include/Ant.h"
 #include "../include/Anthill.h"
 
-Room::Room(const std::string& id, int size_max, int ants)
-    : id_room(id), ANTS_MAX(size_max), ants_inside(ants) {}
+Room::Room(const std::string& id, Graph& graph, int index)
+    : id_room(id), graph(graph), index_room(index), arrival_epoch(0), arrived(0) {}
 
 
 
@@ -19,157 +20,97 @@ Room::~Room() {
 
 
 
-std::string Room::getId() const {
-    // Return a copy of the ID room
+const std::string& Room::getId() const {
+    // Return the ID room without copying it
     return id_room;
 }
 
 
 
-std::deque<Ant*> Room::getAnts() const {
-    // Return a copy of the deque containing ant pointers
-    return ants;
+int Room::getIndex() const {
+    // Return the dense index of the room
+    return index_room;
 }
 
 
 
-Ant* Room::getFirstAnt() const {
-    // Return the first ant in the room, or nullptr if the room is empty
-    if (!ants.empty()) {
-        return ants.front();
-    } else {
-        return nullptr;
-    }
+int Room::getAntsInside() const {
+    // Return the current number of ants in the room, stored in the graph
+    return graph.getOccupancy(index_room);
 }
 
 
 
-
-void Room::addChildNode(Room *child) {
-    // Add the given room as a connected neighbor
-    children.push_back(child);
+int Room::getCapacity() const {
+    // Return the maximum number of ants that can be held in this room, stored in the graph
+    return graph.getCapacity(index_room);
 }
 
 
 
-bool Room::hasAnts() const {
-    // Return true if the room contains at least one ant, false otherwise
-    return !ants.empty();
+void Room::addAntCount(int count) {
+    // Only the number of ants stored in the graph changes
+    graph.addOccupancy(index_room, count);
 }
 
 
 
-int Room::getAntsInside() const {
-    // Return the current number of ants in the room
-    return ants_inside;
+int Room::getMovableAnts(unsigned epoch) const {
+    // The ants that entered during the epoch are the last ones of the queue
+    int waiting = arrival_epoch == epoch ? arrived : 0;
+    return std::max(0, static_cast<int>(ants.size()) - waiting);
 }
 
 
 
-int Room::getCapacity() {
-    // Return the maximum number of ants that can be held in this room
-    return ANTS_MAX;
-}
-
+int Room::transferAnts(Room& destination, int count, unsigned epoch, std::vector<Ant*>* moved) {
+    // Move as many ants as allowed, limited by the space left in the destination
+    int space = destination.getCapacity() - destination.getAntsInside();
+    int moving = std::min(std::min(count, getMovableAnts(epoch)), space);
+    if (moving <= 0) return 0;
 
+    // Splice the front of the queue onto the back of the destination's queue
+    auto first = ants.begin();
+    auto last = ants.begin() + moving;
+    if (moved) moved->insert(moved->end(), first, last);
+    destination.ants.insert(destination.ants.end(), first, last);
+    ants.erase(first, last);
 
-bool Room::canAcceptAnt() const {
-    // Checks if the room can accept a new ant by comparing
-    // the current number of ants with the maximum capacity
-    return ants_inside < ANTS_MAX;
+    graph.addOccupancy(index_room, -moving);
+    graph.addOccupancy(destination.index_room, moving);
+    destination.recordArrivals(moving, epoch);
+    return moving;
 }
 
 
 
-void Room::addAnt(Ant* ant) {
-    // Check if the room can accept another ant
-    if (canAcceptAnt()) {
-        ants_inside += 1;
-        // Add the ant to the room's deque
-        ants.push_back(ant);
-    } else {
-        std::cout << "Room " << id_room << " is full!" << std::endl;
-    }
+int Room::takeAnts(int count, unsigned epoch, std::vector<Ant*>& taken) {
+    // Hand the first movable ants over to the caller
+    int moving = std::min(count, getMovableAnts(epoch));
+    if (moving <= 0) return 0;
 
+    taken.insert(taken.end(), ants.begin(), ants.begin() + moving);
+    ants.erase(ants.begin(), ants.begin() + moving);
+    graph.addOccupancy(index_room, -moving);
+    return moving;
 }
 
 
 
-void Room::removeAnt() {
-    // check if there are any ants to remove
-    if (!ants.empty()) {
-        ants_inside -= 1;
-        // Remove the first ant from the deque
-        ants.pop_front();
-    }
+void Room::receiveAnts(const std::vector<Ant*>& arriving, unsigned epoch) {
+    // The ants join the back of the queue and cannot leave before the next epoch
+    ants.insert(ants.end(), arriving.begin(), arriving.end());
+    graph.addOccupancy(index_room, static_cast<int>(arriving.size()));
+    recordArrivals(static_cast<int>(arriving.size()), epoch);
 }
 
 
 
-void Room::display(int depth, std::set<const Room*>& visited) const {
-    // Avoid infinite recursion by checking if the room was already visited.
-    if (visited.count(this)) return;
-    visited.insert(this);
-
-    // Print indentation on the depth level
-    for (int i = 0; i<depth; i++) std::cout << " ";
-
-    // Display room information: ID and ant occupancy
-    std::cout << "-Room \"" << id_room << "\""
-    << " | Ants: " << ants_inside << "/" << ANTS_MAX;
-
-    // If a room has child connections, display them
-    if (!children.empty()) {
-        std::cout << " | Children: ";
-        for (size_t i = 0; i < children.size(); i++) {
-            std::cout << children[i]->getId();
-            // Add comma separator between children, except for the last one
-            if (i != children.size()-1) std::cout << ", ";
-        }
-    }
-
-    std::cout << std::endl;
-
-    // Recursively display child rooms with increased indentation
-    for (auto child : children) {
-        child->display(depth + 2, visited);
+void Room::recordArrivals(int count, unsigned epoch) {
+    // Start counting again at the first arrival of a new epoch
+    if (arrival_epoch != epoch) {
+        arrival_epoch = epoch;
+        arrived = 0;
     }
+    arrived += count;
 }
-
-
-
-std::vector<Path> Room::findAllPaths(Room* targetRoom, std::set<const Room*>& visited, Path path) {
-    // Initialize vector to store all possible paths
-    std::vector<Path> allPaths;
-
-    // If this room has already been visited, return an empty path list to avoid cycles
-    if (visited.count(this)) return allPaths;
-
-    // Update the path's minimum capacity considering this room's capacity
-    path.capacityMinimum = std::min(path.capacityMinimum, ANTS_MAX);
-    // Add the current room to the path
-    path.path.push_back(this);
-
-    // Mark this room as visited
-    visited.insert(this);
-
-    // If we reached the target room, add the current path to solutions
-    if (this == targetRoom) {
-        allPaths.push_back(path);
-    } else {
-        // Otherwise, recursively explore all child rooms
-        for (auto child : children) {
-            // Create a new visited set for each branch to allow different paths
-            std::set<const Room*> newVisited = visited;
-            // Recursively find paths from child to target
-            auto childPaths = child->findAllPaths(targetRoom, newVisited, path);
-            // Add all found paths to the result
-            allPaths.insert(allPaths.end(), childPaths.begin(), childPaths.end());
-        }
-    }
-
-    return allPaths;
-}
-
-
-
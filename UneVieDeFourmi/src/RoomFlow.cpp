@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <climits>
+#include <map>
+#include <queue>
+#include <utility>
+#include "../include/MaxFlow.h"
+#include "../include/RoomFlow.h"
+
+RoomFlow::RoomFlow(const Graph& graph, int source, int sink, int ant_count, const Deadline* deadline)
+    : value(0), interrupted(false) {
+    int rooms = graph.getNodeCount();
+
+    // Room i has its entry node at 2*i and its exit node at 2*i+1. Room capacities
+    // limit the flow going through each room, except for the start and end rooms
+    MaxFlow network(2 * rooms);
+    for (int room = 0; room < rooms; room++) {
+        bool endpoint = room == source || room == sink;
+        network.addEdge(2 * room, 2 * room + 1, endpoint ? MaxFlow::INFINITE_CAPACITY : graph.getCapacity(room));
+    }
+
+    // Tunnels are crossed instantly and never limit the flow
+    std::vector<std::vector<std::pair<int, int>>> tunnels(rooms);
+    for (int room = 0; room < rooms; room++) {
+        for (int arc = graph.getArcBegin(room); arc < graph.getArcEnd(room); arc++) {
+            int next = graph.getArcTarget(arc);
+            int edge = network.addEdge(2 * room + 1, 2 * next, MaxFlow::INFINITE_CAPACITY);
+            tunnels[room].push_back(std::make_pair(next, edge));
+        }
+    }
+
+    network.setDeadline(deadline);
+    value = network.run(2 * source, 2 * sink + 1, ant_count);
+    interrupted = network.wasInterrupted();
+
+    // Stopped before it carried any ant, the flow still gets a single augmenting path,
+    // so that there is a path whenever one exists
+    if (interrupted && value == 0) {
+        network.setDeadline(nullptr);
+        value = network.run(2 * source, 2 * sink + 1, std::min(ant_count, 1));
+    }
+
+    // Keep the net flow of each tunnel, cancelling flow sent both ways
+    std::vector<std::map<int, long long>> netFlow(rooms);
+    for (int room = 0; room < rooms; room++) {
+        for (const auto& tunnel : tunnels[room]) {
+            netFlow[room][tunnel.first] += network.getFlow(tunnel.second);
+            netFlow[tunnel.first][room] -= network.getFlow(tunnel.second);
+        }
+    }
+
+    // Decompose the flow: repeatedly extract a shortest path carrying positive flow
+    std::vector<int> parent(rooms);
+    while (true) {
+        std::fill(parent.begin(), parent.end(), -1);
+        parent[source] = source;
+        std::queue<int> queue;
+        queue.push(source);
+        while (!queue.empty() && parent[sink] < 0) {
+            int room = queue.front();
+            queue.pop();
+            for (const auto& flow : netFlow[room]) {
+                if (flow.second > 0 && parent[flow.first] < 0) {
+                    parent[flow.first] = room;
+                    queue.push(flow.first);
+                }
+            }
+        }
+        if (parent[sink] < 0) break;
+
+        // Rebuild the path from the end room and remove the flow it carries
+        std::vector<int> path;
+        long long carried = LLONG_MAX;
+        for (int room = sink; room != source; room = parent[room]) {
+            path.push_back(room);
+            carried = std::min(carried, netFlow[parent[room]][room]);
+        }
+        path.push_back(source);
+        std::reverse(path.begin(), path.end());
+        for (size_t i = 1; i < path.size(); i++) {
+            netFlow[path[i - 1]][path[i]] -= carried;
+            netFlow[path[i]][path[i - 1]] += carried;
+        }
+        paths.push_back(path);
+    }
+}
+
+
+
+long long RoomFlow::getValue() const {
+    // Return the flow pushed by Dinic's algorithm
+    return value;
+}
+
+
+
+bool RoomFlow::wasInterrupted() const {
+    // Return whether the deadline cut the computation short
+    return interrupted;
+}
+
+
+
+const std::vector<std::vector<int>>& RoomFlow::getPaths() const {
+    // Return the decomposition computed with the flow
+    return paths;
+}
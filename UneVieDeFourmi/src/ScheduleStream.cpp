@@ -0,0 +1,169 @@
+#include <algorithm>
+#include "../include/Room.h"
+#include "../include/ScheduleStream.h"
+
+ScheduleStream::ScheduleStream(const Graph& graph, int start, int end, long long ant_count,
+                               const std::vector<Path>& paths, const std::vector<int>* quotas)
+    : graph(graph), start(start), end(end), ant_count(ant_count), paths(&paths), schedule(nullptr),
+      limited(quotas != nullptr), occupancy(graph.getNodeCount(), 0), queues(graph.getNodeCount()),
+      arrived(graph.getNodeCount(), 0), arrival_step(graph.getNodeCount(), -1),
+      released(0), step(0), has_pending(false) {
+    // Every ant waits in the start room, numbered in the order it will leave it
+    occupancy[start] = ant_count;
+    if (quotas) remaining.assign(quotas->begin(), quotas->begin() + std::min(quotas->size(), paths.size()));
+    remaining.resize(paths.size(), 0);
+}
+
+
+
+ScheduleStream::ScheduleStream(const Graph& graph, int start, int end, long long ant_count,
+                               const std::vector<std::vector<ScheduledMove>>& schedule)
+    : graph(graph), start(start), end(end), ant_count(ant_count), paths(nullptr), schedule(&schedule),
+      limited(false), occupancy(graph.getNodeCount(), 0), queues(graph.getNodeCount()),
+      arrived(graph.getNodeCount(), 0), arrival_step(graph.getNodeCount(), -1),
+      released(0), step(0), has_pending(false) {
+    // Every ant waits in the start room, numbered in the order it will leave it
+    occupancy[start] = ant_count;
+}
+
+
+
+long long ScheduleStream::getStep() const {
+    // Return the number of steps produced, the one read ahead included
+    return step;
+}
+
+
+
+bool ScheduleStream::next(std::vector<AntMove>& moves) {
+    moves.clear();
+
+    // A schedule ends with its last step, paths once every ant arrived
+    if (schedule ? step == static_cast<long long>(schedule->size()) : occupancy[end] == ant_count) {
+        return false;
+    }
+    step++;
+
+    if (schedule) {
+        for (const ScheduledMove& scheduled : (*schedule)[step - 1]) {
+            move(scheduled.from, scheduled.to, scheduled.ants, moves);
+        }
+        return true;
+    }
+
+    // Move ants from the end to the start of each path, as many as the next room can take
+    for (size_t p = 0; p < paths->size(); p++) {
+        const std::vector<const Room*>& path = (*paths)[p].path;
+        for (int i = static_cast<int>(path.size()) - 2; i >= 0; i--) {
+            int previous = path[i]->getIndex();
+            int current = path[i + 1]->getIndex();
+            long long antsToMove = std::min(occupancy[previous], graph.getCapacity(current) - occupancy[current]);
+            if (limited && i == 0) {
+                antsToMove = std::min(antsToMove, remaining[p]);
+                remaining[p] -= std::max(0LL, antsToMove);
+            }
+            if (antsToMove > 0) move(previous, current, antsToMove, moves);
+        }
+    }
+
+    // No ant can move any more: the remaining ones are stuck
+    if (moves.empty()) {
+        step--;
+        return false;
+    }
+    return true;
+}
+
+
+
+long long ScheduleStream::move(int from, int to, long long count, std::vector<AntMove>& moves) {
+    // Ants that entered the room during this step cannot leave it before the next one
+    long long movable = occupancy[from];
+    if (from != start && arrival_step[from] == step) movable -= arrived[from];
+    long long moving = std::min(count, movable);
+    if (to != end) moving = std::min(moving, graph.getCapacity(to) - occupancy[to]);
+    if (moving <= 0) return 0;
+
+    occupancy[from] -= moving;
+    occupancy[to] += moving;
+    if (arrival_step[to] != step) {
+        arrival_step[to] = step;
+        arrived[to] = 0;
+    }
+    arrived[to] += moving;
+
+    // Ants leaving the start room get the next numbers; others leave their room in order
+    long long left = moving;
+    while (left > 0) {
+        Range taken;
+        if (from == start) {
+            taken = {released + 1, left};
+            released += left;
+        } else {
+            Range& front = queues[from].front();
+            taken = {front.first, std::min(left, front.count)};
+            front.first += taken.count;
+            front.count -= taken.count;
+            if (front.count == 0) queues[from].pop_front();
+        }
+        left -= taken.count;
+        moves.push_back({from, to, taken.first, taken.count});
+
+        // The end room only counts its ants; consecutive numbers share a range
+        if (to == end) continue;
+        std::deque<Range>& queue = queues[to];
+        if (!queue.empty() && queue.back().first + queue.back().count == taken.first) {
+            queue.back().count += taken.count;
+        } else {
+            queue.push_back(taken);
+        }
+    }
+    return moving;
+}
+
+
+
+bool ScheduleStream::nextRun(ScheduleRun& run) {
+    // Start the run with the step read ahead, if any
+    if (!has_pending && !next(pending)) return false;
+    has_pending = false;
+    run.first_step = step;
+    run.repeat = 1;
+    run.shift = 0;
+    run.moves = pending;
+
+    // Extend it while the following steps repeat it
+    while (next(pending)) {
+        long long shift;
+        if (!repeats(run, pending, shift)) {
+            has_pending = true;
+            break;
+        }
+        run.repeat++;
+        run.shift = shift;
+    }
+    return true;
+}
+
+
+
+bool ScheduleStream::repeats(const ScheduleRun& run, const std::vector<AntMove>& moves, long long& shift) {
+    if (moves.size() != run.moves.size()) return false;
+
+    // Same tunnels and numbers of ants, every ant number shifted by the same amount
+    long long offset = (run.repeat - 1) * run.shift;
+    shift = 0;
+    for (size_t i = 0; i < moves.size(); i++) {
+        const AntMove& previous = run.moves[i];
+        if (moves[i].from != previous.from || moves[i].to != previous.to || moves[i].ants != previous.ants) {
+            return false;
+        }
+        long long difference = moves[i].first_ant - (previous.first_ant + offset);
+        if (i == 0) {
+            shift = difference;
+        } else if (difference != shift) {
+            return false;
+        }
+    }
+    return run.repeat == 1 || shift == run.shift;
+}
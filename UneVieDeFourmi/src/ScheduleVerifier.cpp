@@ -0,0 +1,352 @@
+#include <algorithm>
+#include <cstring>
+#include "../include/ScheduleVerifier.h"
+
+namespace {
+
+/**
+ * @brief Ants with consecutive numbers crossing a tunnel, read from a text solution.
+ */
+struct TextMove {
+    long long first_ant;   ///< Number of the first ant.
+    long long ants;        ///< Number of ants.
+    int from;              ///< Index of the room left.
+    int to;                ///< Index of the room entered.
+};
+
+bool isBlank(char c) {
+    // Spaces, tabs and carriage returns (Windows line endings) separate words
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+bool nextWord(const char*& cursor, const char* end, std::string& word) {
+    // Skip the blanks, then take every character up to the next blank
+    while (cursor < end && isBlank(*cursor)) cursor++;
+    const char* first = cursor;
+    while (cursor < end && !isBlank(*cursor)) cursor++;
+    word.assign(first, cursor - first);
+    return cursor > first;
+}
+
+bool readNumber(const char*& cursor, const char* end, long long& value) {
+    // Unsigned decimal number, at most 18 digits so it cannot overflow
+    const char* first = cursor;
+    value = 0;
+    while (cursor < end && *cursor >= '0' && *cursor <= '9' && cursor - first < 18) {
+        value = value * 10 + (*cursor - '0');
+        cursor++;
+    }
+    return cursor > first && (cursor == end || *cursor < '0' || *cursor > '9');
+}
+
+bool skipText(const char*& cursor, const char* end, const char* text) {
+    // Move past the text if the content continues with it
+    size_t length = std::strlen(text);
+    if (static_cast<size_t>(end - cursor) < length || std::memcmp(cursor, text, length) != 0) return false;
+    cursor += length;
+    return true;
+}
+
+} // namespace
+
+
+
+ScheduleVerifier::ScheduleVerifier(const Graph& graph, const std::vector<std::string>& room_ids, int start,
+                                   int end, long long ant_count)
+    : room_ids(room_ids), start(start), end(end), ant_count(ant_count), step(0), last_step(0), move_count(0) {
+    int room_count = graph.getNodeCount();
+
+    // Tunnels of each room, sorted to be searched
+    offsets.assign(room_count + 1, 0);
+    neighbors.reserve(graph.getArcCount());
+    for (int room = 0; room < room_count; room++) {
+        offsets[room] = static_cast<int>(neighbors.size());
+        for (int arc = graph.getArcBegin(room); arc < graph.getArcEnd(room); arc++) {
+            neighbors.push_back(graph.getArcTarget(arc));
+        }
+        std::sort(neighbors.begin() + offsets[room], neighbors.end());
+    }
+    offsets[room_count] = static_cast<int>(neighbors.size());
+
+    // Every ant waits in the start room, which like the end room holds all of them
+    capacity.resize(room_count);
+    for (int room = 0; room < room_count; room++) {
+        capacity[room] = graph.getCapacity(room);
+    }
+    capacity[start] = std::max(capacity[start], ant_count);
+    capacity[end] = std::max(capacity[end], ant_count);
+    occupancy.assign(room_count, 0);
+    occupancy[start] = ant_count;
+    ant_rooms.assign(static_cast<size_t>(ant_count), static_cast<uint32_t>(start));
+
+    // Identifiers of the text solutions, the first room kept when one is repeated
+    room_index.reserve(room_ids.size());
+    for (size_t room = 0; room < room_ids.size(); room++) {
+        room_index.emplace(room_ids[room], static_cast<int>(room));
+    }
+}
+
+
+
+bool ScheduleVerifier::beginStep(long long next_step) {
+    if (!violation.empty()) return false;
+
+    // Steps are numbered from 1 without gaps
+    endStep();
+    if (next_step != step + 1) {
+        return failStep("step E" + std::to_string(next_step) + " follows step E" + std::to_string(step));
+    }
+    step = next_step;
+    return true;
+}
+
+
+
+bool ScheduleVerifier::move(long long ant, int from, int to) {
+    if (!violation.empty()) return false;
+    if (step == 0) {
+        return failStep("move before the first step");
+    }
+
+    // The ant exists and has not moved yet during the step
+    if (ant < 1 || ant > ant_count) {
+        return failStep("ant f" + std::to_string(ant) + " does not exist");
+    }
+    uint32_t& ant_room = ant_rooms[ant - 1];
+    if (ant_room & MOVED) {
+        return failStep("ant f" + std::to_string(ant) + " moves twice");
+    }
+
+    // It leaves its room through a tunnel, to a room with space left
+    if (static_cast<uint32_t>(from) != ant_room) {
+        return failStep("ant f" + std::to_string(ant) + " leaves " + room_ids[from] + " but is in " +
+                    room_ids[ant_room]);
+    }
+    if (!hasTunnel(from, to)) {
+        return failStep("ant f" + std::to_string(ant) + " moves from " + room_ids[from] + " to " + room_ids[to] +
+                    " without a tunnel");
+    }
+    if (occupancy[to] >= capacity[to]) {
+        return failStep("ant f" + std::to_string(ant) + " enters " + room_ids[to] + " holding " +
+                    std::to_string(occupancy[to]) + " ants already (capacity " + std::to_string(capacity[to]) + ")");
+    }
+
+    // Apply the move
+    occupancy[from]--;
+    occupancy[to]++;
+    ant_room = static_cast<uint32_t>(to) | MOVED;
+    moved_ants.push_back(ant);
+    last_step = step;
+    move_count++;
+    return true;
+}
+
+
+
+bool ScheduleVerifier::finish() {
+    if (!violation.empty()) return false;
+    endStep();
+
+    // Every ant ended in the end room, report the first one that did not
+    if (occupancy[end] != ant_count) {
+        for (long long ant = 1; ant <= ant_count; ant++) {
+            if (ant_rooms[ant - 1] != static_cast<uint32_t>(end)) {
+                return fail("after E" + std::to_string(last_step) + " : ant f" + std::to_string(ant) + " ends in " +
+                            room_ids[ant_rooms[ant - 1]] + " (" + std::to_string(ant_count - occupancy[end]) +
+                            " ants not in " + room_ids[end] + ")");
+            }
+        }
+    }
+    return true;
+}
+
+
+
+bool ScheduleVerifier::verifyText(const char* begin, const char* end_text) {
+    const char* cursor = begin;
+    long long line_number = 0;
+    bool started = false;
+    long long block_first = 0;
+    long long block_last = 0;
+    long long block_shift = 0;
+    std::vector<TextMove> block;
+    std::string word;
+
+    // Report a line that cannot be read, with its number
+    auto failLine = [&](const std::string& reason) {
+        return fail("line " + std::to_string(line_number) + " : " + reason);
+    };
+
+    // Replay the moves of the steps of a header, ant numbers shifted from one step to the next
+    auto replayBlock = [&]() {
+        for (long long current = block_first; current <= block_last; current++) {
+            if (!beginStep(current)) return false;
+            long long shift = (current - block_first) * block_shift;
+            for (const TextMove& text_move : block) {
+                for (long long ant = text_move.first_ant; ant < text_move.first_ant + text_move.ants; ant++) {
+                    if (!move(ant + shift, text_move.from, text_move.to)) return false;
+                }
+            }
+        }
+        block.clear();
+        return true;
+    };
+
+    while (cursor < end_text) {
+        const char* line_end = static_cast<const char*>(std::memchr(cursor, '\n', end_text - cursor));
+        if (!line_end) line_end = end_text;
+        line_number++;
+        const char* word_cursor = cursor;
+        while (word_cursor < line_end && isBlank(*word_cursor)) word_cursor++;
+
+        if (skipText(word_cursor, line_end, "+++ E")) {
+            // Step header "+++ E<n> +++", or "+++ E<a> to E<b> (ants +<s> per step) +++"
+            if (started && !replayBlock()) return false;
+            started = true;
+            block_shift = 0;
+            if (!readNumber(word_cursor, line_end, block_first)) {
+                return failLine("unreadable step header");
+            }
+            block_last = block_first;
+            if (skipText(word_cursor, line_end, " to E")) {
+                if (!readNumber(word_cursor, line_end, block_last) || !skipText(word_cursor, line_end, " (ants +") ||
+                    !readNumber(word_cursor, line_end, block_shift) || !skipText(word_cursor, line_end, " per step)") ||
+                    block_last < block_first) {
+                    return failLine("unreadable step header");
+                }
+            }
+            if (!skipText(word_cursor, line_end, " +++")) {
+                return failLine("unreadable step header");
+            }
+        } else if (started && word_cursor < line_end && *word_cursor == 'f') {
+            // Move "f<a> - <from> - <to>", or "f<a>..f<b> - <from> - <to>"
+            TextMove text_move;
+            word_cursor++;
+            long long last_ant = 0;
+            if (!readNumber(word_cursor, line_end, text_move.first_ant)) {
+                return failLine("unreadable move");
+            }
+            last_ant = text_move.first_ant;
+            if (skipText(word_cursor, line_end, "..f") && !readNumber(word_cursor, line_end, last_ant)) {
+                return failLine("unreadable move");
+            }
+            text_move.ants = last_ant - text_move.first_ant + 1;
+            int rooms[2];
+            for (int& room : rooms) {
+                if (!nextWord(word_cursor, line_end, word) || word != "-" || !nextWord(word_cursor, line_end, word)) {
+                    return failLine("unreadable move");
+                }
+                auto found = room_index.find(word);
+                if (found == room_index.end()) {
+                    return failLine("unknown room " + word);
+                }
+                room = found->second;
+            }
+            if (text_move.ants < 1 || nextWord(word_cursor, line_end, word)) {
+                return failLine("unreadable move");
+            }
+            text_move.from = rooms[0];
+            text_move.to = rooms[1];
+            block.push_back(text_move);
+        } else if (started && word_cursor < line_end && !skipText(word_cursor, line_end, "All ants have reached")) {
+            return failLine("unreadable line");
+        }
+        cursor = line_end + 1;
+    }
+
+    // The last header and its moves, then the final positions
+    if (started && !replayBlock()) return false;
+    return finish();
+}
+
+
+
+bool ScheduleVerifier::verifyBinary(const BinaryScheduleReader& reader) {
+    // Rooms of the solution are matched to the anthill by identifier
+    const std::vector<std::string>& ids = reader.getRoomIds();
+    std::vector<int> rooms(ids.size());
+    for (size_t room = 0; room < ids.size(); room++) {
+        auto found = room_index.find(ids[room]);
+        if (found == room_index.end()) {
+            return fail("unknown room " + ids[room]);
+        }
+        rooms[room] = found->second;
+    }
+    if (reader.getAntCount() != ant_count) {
+        return fail("the solution moves " + std::to_string(reader.getAntCount()) + " ants instead of " +
+                    std::to_string(ant_count));
+    }
+
+    // Replay every step of the index
+    std::vector<BinaryMove> moves;
+    for (long long current = 1; current <= reader.getStepCount(); current++) {
+        if (!beginStep(current)) return false;
+        reader.readStep(current, moves);
+        for (const BinaryMove& binary_move : moves) {
+            if (!move(binary_move.ant, rooms[binary_move.from], rooms[binary_move.to])) return false;
+        }
+    }
+    return finish();
+}
+
+
+
+bool ScheduleVerifier::isValid() const {
+    // Valid while no violation was found
+    return violation.empty();
+}
+
+
+
+const std::string& ScheduleVerifier::getViolation() const {
+    // Return the first violation found
+    return violation;
+}
+
+
+
+long long ScheduleVerifier::getStepCount() const {
+    // Return the last step that moved an ant
+    return last_step;
+}
+
+
+
+long long ScheduleVerifier::getMoveCount() const {
+    // Return the number of moves replayed
+    return move_count;
+}
+
+
+
+bool ScheduleVerifier::fail(const std::string& reason) {
+    // Keep the first violation only
+    if (violation.empty()) {
+        violation = reason;
+    }
+    return false;
+}
+
+
+
+bool ScheduleVerifier::failStep(const std::string& reason) {
+    // Name the step the violation happened in
+    return fail("E" + std::to_string(step) + " : " + reason);
+}
+
+
+
+bool ScheduleVerifier::hasTunnel(int from, int to) const {
+    // Binary search among the sorted tunnels of the room left
+    return std::binary_search(neighbors.begin() + offsets[from], neighbors.begin() + offsets[from + 1], to);
+}
+
+
+
+void ScheduleVerifier::endStep() {
+    // The ants that moved may move again during the next step
+    for (long long ant : moved_ants) {
+        ant_rooms[ant - 1] &= ~MOVED;
+    }
+    moved_ants.clear();
+}
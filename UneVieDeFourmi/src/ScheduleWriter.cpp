@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include "../include/ScheduleWriter.h"
+
+const size_t ScheduleWriter::BUFFER_SIZE = 1 << 20;
+
+
+
+ScheduleWriter::ScheduleWriter()
+    : file(stdout), owned(false), buffer(BUFFER_SIZE), used(0) {
+    // Text displayed so far comes before the solution
+    std::cout.flush();
+}
+
+
+
+ScheduleWriter::ScheduleWriter(const std::string& filename)
+    : file(std::fopen(filename.c_str(), "wb")), owned(true), buffer(BUFFER_SIZE), used(0) {
+    if (!file) {
+        throw std::runtime_error("Could not open file " + filename);
+    }
+}
+
+
+
+ScheduleWriter::~ScheduleWriter() {
+    // Errors cannot be reported from a destructor: write out what can be
+    if (used > 0) {
+        std::fwrite(buffer.data(), 1, used, file);
+    }
+    std::fflush(file);
+    if (owned) {
+        std::fclose(file);
+    }
+}
+
+
+
+void ScheduleWriter::writeStep(long long step) {
+    // "\n+++ E<step> +++\n"
+    append("\n+++ E", 6);
+    appendNumber(step);
+    append(" +++\n", 5);
+}
+
+
+
+void ScheduleWriter::writeMove(const std::string& ant, const std::string& from, const std::string& to) {
+    // "<ant> - <from> - <to>\n", in place when the buffer has room
+    size_t length = ant.size() + from.size() + to.size() + 7;
+    if (used + length > buffer.size()) {
+        append(ant.data(), ant.size());
+        append(" - ", 3);
+        append(from.data(), from.size());
+        append(" - ", 3);
+        append(to.data(), to.size());
+        append("\n", 1);
+        return;
+    }
+
+    char* cursor = buffer.data() + used;
+    std::memcpy(cursor, ant.data(), ant.size());
+    cursor += ant.size();
+    std::memcpy(cursor, " - ", 3);
+    cursor += 3;
+    std::memcpy(cursor, from.data(), from.size());
+    cursor += from.size();
+    std::memcpy(cursor, " - ", 3);
+    cursor += 3;
+    std::memcpy(cursor, to.data(), to.size());
+    cursor += to.size();
+    *cursor = '\n';
+    used += length;
+}
+
+
+
+void ScheduleWriter::writeSteps(long long first, long long last, long long shift) {
+    // "\n+++ E<first> to E<last> (ants +<shift> per step) +++\n"
+    append("\n+++ E", 6);
+    appendNumber(first);
+    append(" to E", 5);
+    appendNumber(last);
+    append(" (ants +", 8);
+    appendNumber(shift);
+    append(" per step) +++\n", 15);
+}
+
+
+
+void ScheduleWriter::writeMoves(long long first_ant, long long ants, const std::string& from, const std::string& to) {
+    // "f<first> - <from> - <to>\n", or "f<first>..f<last> - <from> - <to>\n" for several ants
+    append("f", 1);
+    appendNumber(first_ant);
+    if (ants > 1) {
+        append("..f", 3);
+        appendNumber(first_ant + ants - 1);
+    }
+    append(" - ", 3);
+    append(from.data(), from.size());
+    append(" - ", 3);
+    append(to.data(), to.size());
+    append("\n", 1);
+}
+
+
+
+void ScheduleWriter::writeLine(const std::string& text) {
+    // The text followed by a line break
+    append(text.data(), text.size());
+    append("\n", 1);
+}
+
+
+
+void ScheduleWriter::flush() {
+    // One write for the whole buffer
+    if (used > 0 && std::fwrite(buffer.data(), 1, used, file) != used) {
+        used = 0;
+        throw std::runtime_error("Could not write the solution");
+    }
+    used = 0;
+    if (std::fflush(file) != 0) {
+        throw std::runtime_error("Could not write the solution");
+    }
+}
+
+
+
+void ScheduleWriter::append(const char* text, size_t length) {
+    while (length > 0) {
+        if (used == buffer.size()) flush();
+
+        // Copy as much as fits, the rest after writing out the buffer
+        size_t chunk = std::min(length, buffer.size() - used);
+        std::memcpy(buffer.data() + used, text, chunk);
+        used += chunk;
+        text += chunk;
+        length -= chunk;
+    }
+}
+
+
+
+void ScheduleWriter::appendNumber(long long value) {
+    // Digits are produced from the last one
+    char digits[24];
+    char* end = digits + sizeof(digits);
+    char* cursor = end;
+    unsigned long long magnitude = value < 0 ? 0ULL - static_cast<unsigned long long>(value) : value;
+    do {
+        *--cursor = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0) *--cursor = '-';
+    append(cursor, end - cursor);
+}
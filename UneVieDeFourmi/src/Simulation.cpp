@@ -0,0 +1,80 @@
+#include <algorithm>
+#include "../include/Room.h"
+#include "../include/Simulation.h"
+
+SimulationState::SimulationState(const Graph& graph, int start, int ant_count)
+    : occupancy(graph.getNodeCount(), 0), arrived(graph.getNodeCount(), 0),
+      arrival_step(graph.getNodeCount(), -1), step(0) {
+    // Every ant starts in the start room
+    occupancy[start] = ant_count;
+}
+
+
+
+int simulate(const Graph& graph, const std::vector<Path>& paths, size_t path_count,
+             int end, int ant_count, SimulationState& state,
+             const std::vector<int>* quotas, int limit, const Deadline* deadline) {
+    int steps = 0;
+    bool someAntMoved;
+
+    // Ants that may still leave the start room through each path
+    std::vector<int> remaining;
+    if (quotas) remaining.assign(quotas->begin(), quotas->begin() + path_count);
+
+    do {
+        someAntMoved = false;
+        // A new step: every ant may move again
+        state.step++;
+
+        // Check if all ants have reached the end room
+        if (state.occupancy[end] == ant_count) {
+            break;
+        }
+
+        // Another step would not beat the limit
+        if (steps >= limit) {
+            return limit;
+        }
+
+        // Reading the clock at every step would slow short simulations down
+        if (deadline && (steps & 255) == 255 && deadline->hasExpired()) {
+            return -1;
+        }
+
+        // Try moving ants along each path
+        for (size_t p = 0; p < path_count; p++) {
+            const std::vector<const Room*>& path = paths[p].path;
+
+            // Move ants from back to front of each path
+            for (int i = static_cast<int>(path.size()) - 2; i >= 0; i--) {
+                int previous = path[i]->getIndex();
+                int current = path[i + 1]->getIndex();
+
+                // Calculate how many ants can move
+                int antsInPrevious = state.occupancy[previous];
+                int spaceInCurrent = graph.getCapacity(current) - state.occupancy[current];
+                int antsToMove = std::min(antsInPrevious, spaceInCurrent);
+                if (quotas && i == 0) antsToMove = std::min(antsToMove, remaining[p]);
+
+                if (antsToMove > 0) {
+                    // Ants that arrived during this step wait at the back of the queue
+                    int waiting = state.arrival_step[previous] == state.step ? state.arrived[previous] : 0;
+                    int moving = std::min(antsToMove, antsInPrevious - waiting);
+                    if (quotas && i == 0) remaining[p] -= moving;
+
+                    state.occupancy[previous] -= moving;
+                    state.occupancy[current] += moving;
+                    if (state.arrival_step[current] != state.step) {
+                        state.arrival_step[current] = state.step;
+                        state.arrived[current] = 0;
+                    }
+                    state.arrived[current] += moving;
+                    someAntMoved = true;
+                }
+            }
+        }
+        steps++;
+    } while (someAntMoved); // Continue while ants are still moving
+
+    return steps; // Return the total number of steps needed
+}
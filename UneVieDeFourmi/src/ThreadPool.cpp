@@ -0,0 +1,157 @@
+#include "../include/ThreadPool.h"
+
+namespace {
+
+// Index of the worker running on the current thread, -1 outside any pool
+thread_local int worker_index = -1;
+
+} // namespace
+
+
+
+ThreadPool::ThreadPool(unsigned thread_count)
+    : queued(0), pending(0), idle(0), next_queue(0), stopping(false) {
+    // hardware_concurrency() may return 0 when it is unknown
+    if (thread_count == 0) thread_count = 1;
+
+    for (unsigned i = 0; i < thread_count; i++) {
+        queues.emplace_back(new Queue());
+    }
+    for (unsigned i = 0; i < thread_count; i++) {
+        threads.emplace_back(&ThreadPool::work, this, i);
+    }
+}
+
+
+
+ThreadPool::~ThreadPool() {
+    // Let the workers finish the queued tasks, then exit
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return pending == 0; });
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+
+
+void ThreadPool::submit(std::function<void()> task) {
+    pending++;
+
+    // Workers keep their own tasks, other threads spread them over the deques
+    unsigned index = worker_index >= 0 ? static_cast<unsigned>(worker_index)
+                                       : next_queue++ % static_cast<unsigned>(queues.size());
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+
+    // Count the task under the pool lock so a worker about to sleep sees it
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queued++;
+    }
+    wake.notify_one();
+}
+
+
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return pending == 0; });
+
+    // Report the first failure once, to the thread waiting for the results
+    if (failure) {
+        std::exception_ptr error = failure;
+        failure = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+
+
+unsigned ThreadPool::getThreadCount() const {
+    // Return the number of workers
+    return static_cast<unsigned>(threads.size());
+}
+
+
+
+bool ThreadPool::isStarving() const {
+    // A worker sleeps and nothing is queued for it
+    return idle > 0 && queued == 0;
+}
+
+
+
+int ThreadPool::getWorkerIndex() {
+    // Return the index of the worker owning the current thread
+    return worker_index;
+}
+
+
+
+bool ThreadPool::takeTask(unsigned index, std::function<void()>& task) {
+    // Newest task of the worker's own deque first
+    {
+        Queue& own = *queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            queued--;
+            return true;
+        }
+    }
+
+    // Otherwise steal the oldest task of another worker
+    for (size_t offset = 1; offset < queues.size(); offset++) {
+        Queue& other = *queues[(index + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.tasks.empty()) {
+            task = std::move(other.tasks.front());
+            other.tasks.pop_front();
+            queued--;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+
+void ThreadPool::work(unsigned index) {
+    worker_index = static_cast<int>(index);
+    std::function<void()> task;
+
+    while (true) {
+        if (takeTask(index, task)) {
+            // Run the task, keeping the first exception for wait()
+            try {
+                task();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!failure) failure = std::current_exception();
+            }
+            task = nullptr;
+
+            // Wake the threads waiting for completion after the last task
+            if (--pending == 0) {
+                std::lock_guard<std::mutex> lock(mutex);
+                done.notify_all();
+            }
+            continue;
+        }
+
+        // Nothing to run: sleep until a task is queued or the pool stops
+        std::unique_lock<std::mutex> lock(mutex);
+        idle++;
+        wake.wait(lock, [this] { return queued > 0 || stopping; });
+        idle--;
+        if (stopping && queued == 0) return;
+    }
+}
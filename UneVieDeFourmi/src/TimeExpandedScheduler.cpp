@@ -0,0 +1,260 @@
+#include <algorithm>
+#include <climits>
+#include <map>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "../include/MaxFlow.h"
+#include "../include/TimeExpandedScheduler.h"
+
+const long long TimeExpandedScheduler::DEFAULT_MAXIMUM_ARCS = 1 << 20;
+
+const long long TimeExpandedScheduler::LARGEST_MAXIMUM_ARCS = INT_MAX / 2;
+
+
+
+TimeExpandedScheduler::TimeExpandedScheduler(const Graph& graph, int source, int sink, int ant_count)
+    : graph(graph), source(source), sink(sink), ant_count(ant_count),
+      from_source(distancesFrom(source)), to_sink(distancesFrom(sink)), maximum_arcs(DEFAULT_MAXIMUM_ARCS),
+      deadline(nullptr), interrupted(false) {}
+
+
+
+std::vector<int> TimeExpandedScheduler::distancesFrom(int origin) const {
+    // Breadth-first search (tunnels go both ways, so distances to a room are the same)
+    std::vector<int> distance(graph.getNodeCount(), -1);
+    std::queue<int> queue;
+    distance[origin] = 0;
+    queue.push(origin);
+
+    while (!queue.empty()) {
+        int room = queue.front();
+        queue.pop();
+        for (int arc = graph.getArcBegin(room); arc < graph.getArcEnd(room); arc++) {
+            int next = graph.getArcTarget(arc);
+            if (distance[next] < 0) {
+                distance[next] = distance[room] + 1;
+                queue.push(next);
+            }
+        }
+    }
+    return distance;
+}
+
+
+
+void TimeExpandedScheduler::setMaximumArcs(long long arcs) {
+    // The flow network numbers its edges, two per arc, with ints
+    if (arcs < 1 || arcs > LARGEST_MAXIMUM_ARCS) {
+        throw std::invalid_argument("The arc limit of the schedule search must be between 1 and " +
+                                    std::to_string(LARGEST_MAXIMUM_ARCS));
+    }
+    maximum_arcs = arcs;
+}
+
+
+
+void TimeExpandedScheduler::setDeadline(const Deadline* deadline) {
+    // The search stops once this deadline expires
+    this->deadline = deadline;
+}
+
+
+
+bool TimeExpandedScheduler::wasInterrupted() const {
+    // Return whether the deadline cut the last search short
+    return interrupted;
+}
+
+
+
+int TimeExpandedScheduler::solve(int upper, std::vector<std::vector<ScheduledMove>>& schedule, int lower) {
+    schedule.clear();
+    interrupted = false;
+    if (ant_count == 0) return 0;
+
+    // No ant can arrive before the length of the shortest path
+    lower = std::max(lower, std::max(1, to_sink[source]));
+    if (to_sink[source] < 0 || lower > upper) return -1;
+
+    // The largest network must stay within the budget
+    long long rooms = graph.getNodeCount();
+    long long arcs = (upper + 1) * rooms + upper * (rooms + graph.getArcCount());
+    if (arcs > maximum_arcs) return -1;
+
+    // Binary search on the horizon: the ants fit in T steps if they fit in fewer. The
+    // schedule of the shortest horizon that fits is kept from its feasibility run
+    int known = upper;
+    std::vector<std::vector<ScheduledMove>> trial;
+    if (!fits(upper, &trial)) return -1;
+    schedule.swap(trial);
+    while (lower < upper) {
+        if (deadline && deadline->hasExpired()) {
+            interrupted = true;
+            break;
+        }
+        int middle = lower + (upper - lower) / 2;
+        if (fits(middle, &trial)) {
+            upper = middle;
+            schedule.swap(trial);
+        } else if (interrupted) {
+            break;
+        } else {
+            lower = middle + 1;
+        }
+    }
+
+    // Without a shorter horizon, the known schedule is as good
+    if (interrupted && upper == known) {
+        schedule.clear();
+        return -1;
+    }
+    return upper;
+}
+
+
+
+bool TimeExpandedScheduler::fits(int steps, std::vector<std::vector<ScheduledMove>>* schedule) {
+    int rooms = graph.getNodeCount();
+
+    // Entry node of a room at the end of a step; its exit node follows it
+    auto entry = [rooms](int room, int step) { return 2 * (step * rooms + room); };
+
+    // A copy of a room is only useful if it can be reached in time and still reach the end room
+    auto usable = [&](int room, int step) {
+        return from_source[room] >= 0 && from_source[room] <= step &&
+               to_sink[room] >= 0 && to_sink[room] <= steps - step;
+    };
+
+    MaxFlow network(2 * rooms * (steps + 1));
+    for (int step = 0; step <= steps; step++) {
+        for (int room = 0; room < rooms; room++) {
+            if (usable(room, step)) {
+                network.addEdge(entry(room, step), entry(room, step) + 1, graph.getCapacity(room));
+            }
+        }
+    }
+
+    // Ants wait or cross a tunnel; they never come back to the start room nor leave the end room
+    struct Crossing {
+        int step;   ///< Step during which the tunnel is crossed (0 for the first step).
+        int from;   ///< Index of the room left.
+        int to;     ///< Index of the room entered.
+        int edge;   ///< Identifier of the network edge.
+    };
+    std::vector<Crossing> crossings;
+    for (int step = 0; step < steps; step++) {
+        for (int room = 0; room < rooms; room++) {
+            if (!usable(room, step)) continue;
+            if (usable(room, step + 1)) {
+                network.addEdge(entry(room, step) + 1, entry(room, step + 1), MaxFlow::INFINITE_CAPACITY);
+            }
+            if (room == sink) continue;
+
+            for (int arc = graph.getArcBegin(room); arc < graph.getArcEnd(room); arc++) {
+                int next = graph.getArcTarget(arc);
+                if (next == source || !usable(next, step + 1)) continue;
+                int edge = network.addEdge(entry(room, step) + 1, entry(next, step + 1), MaxFlow::INFINITE_CAPACITY);
+                crossings.push_back({step, room, next, edge});
+            }
+        }
+    }
+
+    // A flow cut short by the deadline tells nothing about the horizon
+    network.setDeadline(deadline);
+    long long flow = network.run(entry(source, 0), entry(sink, steps) + 1, ant_count);
+    if (network.wasInterrupted()) {
+        interrupted = true;
+        return false;
+    }
+    if (flow < ant_count) return false;
+    if (!schedule) return true;
+
+    // Gather the ants crossing each tunnel at each step, cancelling crossings both ways
+    std::vector<std::map<std::pair<int, int>, long long>> crossed(steps);
+    for (const Crossing& crossing : crossings) {
+        long long flow = network.getFlow(crossing.edge);
+        if (flow > 0) {
+            crossed[crossing.step][std::make_pair(crossing.from, crossing.to)] += flow;
+        }
+    }
+
+    std::vector<long long> occupancy(rooms, 0);
+    occupancy[source] = ant_count;
+    schedule->assign(steps, std::vector<ScheduledMove>());
+    for (int step = 0; step < steps; step++) {
+        std::vector<ScheduledMove> moves;
+        for (const auto& tunnel : crossed[step]) {
+            auto back = crossed[step].find(std::make_pair(tunnel.first.second, tunnel.first.first));
+            long long ants = tunnel.second - (back != crossed[step].end() ? std::min(tunnel.second, back->second) : 0);
+            if (ants > 0) {
+                moves.push_back({tunnel.first.first, tunnel.first.second, static_cast<int>(ants)});
+            }
+        }
+        (*schedule)[step] = orderMoves(std::move(moves), occupancy);
+    }
+    return true;
+}
+
+
+
+std::vector<ScheduledMove> TimeExpandedScheduler::orderMoves(std::vector<ScheduledMove> moves,
+                                                             std::vector<long long>& occupancy) const {
+    std::vector<ScheduledMove> ordered;
+    std::vector<int> position(graph.getNodeCount(), -1);
+
+    while (!moves.empty()) {
+        // Carry out every move whose destination has room, as far as it has room
+        bool progress = false;
+        for (ScheduledMove& move : moves) {
+            long long space = graph.getCapacity(move.to) - occupancy[move.to];
+            int ants = static_cast<int>(std::min<long long>(move.ants, space));
+            if (ants <= 0) continue;
+
+            ordered.push_back({move.from, move.to, ants});
+            occupancy[move.from] -= ants;
+            occupancy[move.to] += ants;
+            move.ants -= ants;
+            progress = true;
+        }
+        moves.erase(std::remove_if(moves.begin(), moves.end(),
+            [](const ScheduledMove& move) { return move.ants == 0; }), moves.end());
+        if (progress || moves.empty()) continue;
+
+        // Every destination is full, so it is also left by a move: follow the moves
+        // from room to room until one comes back, and cancel the cycle found
+        std::vector<size_t> chain;
+        std::vector<int> visited;
+        int room = moves[0].to;
+        while (position[room] < 0) {
+            position[room] = static_cast<int>(chain.size());
+            visited.push_back(room);
+            size_t next = 0;
+            while (next < moves.size() && moves[next].from != room) next++;
+            if (next == moves.size()) break;
+            chain.push_back(next);
+            room = moves[next].to;
+        }
+        if (position[room] < 0 || chain.size() == static_cast<size_t>(position[room])) {
+            // Cannot happen with a valid flow: keep the remaining moves as they are
+            ordered.insert(ordered.end(), moves.begin(), moves.end());
+            break;
+        }
+
+        int cancelled = moves[chain[position[room]]].ants;
+        for (size_t i = position[room]; i < chain.size(); i++) {
+            cancelled = std::min(cancelled, moves[chain[i]].ants);
+        }
+        for (size_t i = position[room]; i < chain.size(); i++) {
+            moves[chain[i]].ants -= cancelled;
+        }
+        for (int seen : visited) {
+            position[seen] = -1;
+        }
+        moves.erase(std::remove_if(moves.begin(), moves.end(),
+            [](const ScheduledMove& move) { return move.ants == 0; }), moves.end());
+    }
+
+    return ordered;
+}
@@ -0,0 +1,34 @@
+# Solves an anthill in one mode of the solver, then checks the solution with the verifier.
+#
+# Variables:
+#   SOLVER    path of uneviedefourmi
+#   VERIFIER  path of uneviedefourmi_verifier
+#   ANTHILL   anthill file
+#   MODE      default, greedy, lazy, maxflow, summary or binary
+#   OUTPUT    path of the files written, without extension
+
+set(arguments ${ANTHILL} --time-limit 10)
+set(solution ${OUTPUT}.txt)
+if(MODE STREQUAL "binary")
+    set(solution ${OUTPUT}.bin)
+    list(APPEND arguments --binary ${solution})
+elseif(NOT MODE STREQUAL "default")
+    list(APPEND arguments --${MODE})
+endif()
+
+execute_process(COMMAND ${SOLVER} ${arguments}
+        OUTPUT_FILE ${OUTPUT}.txt
+        ERROR_VARIABLE errors
+        RESULT_VARIABLE status)
+if(NOT status EQUAL 0)
+    message(FATAL_ERROR "${SOLVER} ${arguments} failed (${status}) : ${errors}")
+endif()
+
+execute_process(COMMAND ${VERIFIER} ${ANTHILL} ${solution}
+        OUTPUT_VARIABLE report
+        ERROR_VARIABLE report
+        RESULT_VARIABLE status)
+if(NOT status EQUAL 0)
+    message(FATAL_ERROR "Solution of ${ANTHILL} in ${MODE} mode rejected : ${report}")
+endif()
+message(STATUS "${report}")
@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+#include "../include/Graph.h"
+#include "../include/LowerBound.h"
+#include "../include/Makespan.h"
+#include "../include/Path.h"
+#include "../include/Room.h"
+#include "../include/Simulation.h"
+#include "../include/TimeExpandedScheduler.h"
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const std::string& what) {
+    // Report every failed property, the run failing at the end
+    if (!condition) {
+        std::cerr << "Failed : " << what << std::endl;
+        failures++;
+    }
+}
+
+class Random {
+public:
+    explicit Random(uint64_t seed) : state(seed) {}
+
+    int below(int bound) {
+        // splitmix64, so every platform draws the same cases
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return static_cast<int>((z ^ (z >> 31)) % static_cast<uint64_t>(bound));
+    }
+
+private:
+    uint64_t state;
+};
+
+/**
+ * @brief Anthill built in memory: the start room is 0 and the end room is 1.
+ */
+struct TestAnthill {
+    Graph graph;
+    std::vector<std::unique_ptr<Room>> rooms;
+
+    explicit TestAnthill(int ant_count) {
+        addRoom(ant_count);
+        addRoom(ant_count);
+    }
+
+    int addRoom(int capacity) {
+        int index = graph.addNode(capacity);
+        rooms.emplace_back(new Room("S" + std::to_string(index), graph, index));
+        return index;
+    }
+
+    void link(int a, int b) {
+        graph.addEdge(a, b);
+        graph.addEdge(b, a);
+    }
+
+    Path makePath(const std::vector<int>& indices) const {
+        Path path(graph.getCapacity(indices[0]));
+        for (int index : indices) {
+            path.capacityMinimum = std::min(path.capacityMinimum, graph.getCapacity(index));
+            path.path.push_back(rooms[index].get());
+        }
+        return path;
+    }
+};
+
+
+
+void checkMakespan(uint64_t seed) {
+    Random random(seed);
+    int ant_count = 1 + random.below(200);
+    TestAnthill anthill(ant_count);
+
+    // Room-disjoint paths from the start room to the end room, the first one
+    // possibly a direct tunnel
+    std::vector<std::vector<int>> indices;
+    int path_count = 1 + random.below(8);
+    for (int p = 0; p < path_count; p++) {
+        std::vector<int> rooms(1, 0);
+        int inner = p == 0 ? random.below(6) : 1 + random.below(6);
+        for (int i = 0; i < inner; i++) {
+            rooms.push_back(anthill.addRoom(1 + random.below(4)));
+        }
+        rooms.push_back(1);
+        indices.push_back(rooms);
+    }
+    for (const auto& rooms : indices) {
+        for (size_t i = 0; i + 1 < rooms.size(); i++) {
+            anthill.link(rooms[i], rooms[i + 1]);
+        }
+    }
+    anthill.graph.build();
+
+    std::vector<Path> paths;
+    for (const auto& rooms : indices) {
+        paths.push_back(anthill.makePath(rooms));
+    }
+
+    // Every prefix: the closed form, its incremental form and the simulation with
+    // its quotas agree, and nothing beats the lower bound
+    const std::string name = "makespan, seed " + std::to_string(seed);
+    LowerBound bound(anthill.graph, 0, 1, ant_count);
+    MakespanEvaluator evaluator(ant_count);
+    for (size_t count = 1; count <= paths.size(); count++) {
+        std::vector<int> quotas;
+        int steps = computeMakespan(paths, count, ant_count, quotas);
+        check(evaluator.addPath(paths[count - 1]) == steps, name + " : MakespanEvaluator differs from computeMakespan");
+
+        SimulationState state(anthill.graph, 0, ant_count);
+        check(simulate(anthill.graph, paths, count, 1, ant_count, state, &quotas) == steps,
+              name + " : simulate with quotas differs from computeMakespan");
+
+        SimulationState greedy(anthill.graph, 0, ant_count);
+        check(simulate(anthill.graph, paths, count, 1, ant_count, greedy) >= steps,
+              name + " : simulate without quotas beats computeMakespan");
+        check(bound.getSteps() <= steps, name + " : computeMakespan beats the lower bound");
+    }
+}
+
+
+
+void checkLowerBound(uint64_t seed) {
+    Random random(seed);
+    int ant_count = 1 + random.below(30);
+    TestAnthill anthill(ant_count);
+
+    // Random rooms, each linked to an earlier room so that all of them are connected
+    int room_count = 2 + random.below(10);
+    for (int i = 0; i < room_count; i++) {
+        int room = anthill.addRoom(1 + random.below(3));
+        anthill.link(room, random.below(room));
+    }
+    int extra = random.below(room_count * 2);
+    for (int i = 0; i < extra; i++) {
+        int a = random.below(room_count + 2);
+        int b = random.below(room_count + 2);
+        if (a != b && !(a <= 1 && b <= 1)) anthill.link(a, b);
+    }
+    anthill.graph.build();
+
+    // A shortest path gives a schedule for the largest horizon
+    const Graph& graph = anthill.graph;
+    std::vector<int> parent(graph.getNodeCount(), -1);
+    std::queue<int> queue;
+    parent[0] = 0;
+    queue.push(0);
+    while (!queue.empty()) {
+        int room = queue.front();
+        queue.pop();
+        for (int arc = graph.getArcBegin(room); arc < graph.getArcEnd(room); arc++) {
+            int next = graph.getArcTarget(arc);
+            if (parent[next] < 0) {
+                parent[next] = room;
+                queue.push(next);
+            }
+        }
+    }
+    std::vector<int> shortest;
+    for (int room = 1; room != 0; room = parent[room]) {
+        shortest.push_back(room);
+    }
+    shortest.push_back(0);
+    std::reverse(shortest.begin(), shortest.end());
+    std::vector<Path> paths(1, anthill.makePath(shortest));
+    std::vector<int> quotas;
+    int upper = computeMakespan(paths, 1, ant_count, quotas);
+
+    // The optimum found from step 0 on never beats the lower bound
+    const std::string name = "lower bound, seed " + std::to_string(seed);
+    std::vector<std::vector<ScheduledMove>> schedule;
+    TimeExpandedScheduler scheduler(graph, 0, 1, ant_count);
+    int steps = scheduler.solve(upper, schedule, 0);
+    int optimum = steps < 0 ? upper : steps;
+    check(optimum <= upper, name + " : the scheduler is worse than a shortest path");
+    check(steps < 0 || static_cast<int>(schedule.size()) == steps, name + " : the schedule length differs");
+    check(LowerBound(graph, 0, 1, ant_count).getSteps() <= optimum, name + " : the lower bound beats the optimum");
+}
+
+} // namespace
+
+int main() {
+    // Fixed seeds, so that a failure names a case that can be run again
+    for (uint64_t seed = 1; seed <= 2000; seed++) {
+        checkMakespan(seed);
+    }
+    for (uint64_t seed = 1; seed <= 500; seed++) {
+        checkLowerBound(seed);
+    }
+
+    if (failures > 0) {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <exception>
+#include "include/AnthillReader.h"
+#include "include/BinarySchedule.h"
+#include "include/MappedFile.h"
+#include "include/ScheduleVerifier.h"
+
+int main(int argc, char* argv[]) {
+    try {
+        std::string anthillFile;
+        std::string solutionFile;
+
+        // Read the anthill and the solution from the command line, an option or a third
+        // file stopping with the usage
+        bool known = true;
+        for (int i = 1; i < argc && known; i++) {
+            const std::string arg = argv[i];
+            if (arg[0] == '-') {
+                known = false;
+            } else if (anthillFile.empty()) {
+                anthillFile = arg;
+            } else if (solutionFile.empty()) {
+                solutionFile = arg;
+            } else {
+                known = false;
+            }
+        }
+        if (!known || solutionFile.empty()) {
+            std::cerr << "Usage : " << argv[0] << " <anthill file> <solution file>" << std::endl;
+            return 2;
+        }
+
+        // The anthill gives the rooms, their capacities and the tunnels, read without the solver
+        AnthillReader anthill(anthillFile);
+        ScheduleVerifier verifier(anthill.getGraph(), anthill.getRoomIds(), anthill.getStart(), anthill.getEnd(),
+                                  anthill.getAntCount());
+
+        // Binary solutions are recognized by their magic, anything else is read as text
+        MappedFile solution(solutionFile);
+        if (solution.size() >= 4 && std::memcmp(solution.begin(), "UVDS", 4) == 0) {
+            BinaryScheduleReader reader(solution.begin(), solution.end());
+            verifier.verifyBinary(reader);
+        } else {
+            verifier.verifyText(solution.begin(), solution.end());
+        }
+
+        if (!verifier.isValid()) {
+            std::cout << "Invalid solution : " << verifier.getViolation() << std::endl;
+            return 1;
+        }
+        std::cout << "Valid solution : " << verifier.getStepCount() << " steps, "
+                  << verifier.getMoveCount() << " moves" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error : " << e.what() << std::endl;
+        return 2;
+    }
+
+    return 0;
+}